@@ -0,0 +1,52 @@
+//
+// Microbenchmark for DequeueBlocks::batch_prepend over batch sizes 10 .. 10^6.
+// Usage: batch_prepend_bench [M] [duplicate_ratio]
+//
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "BlockLinkedList.h"
+
+int main(const int argc, char** argv) {
+    const size_t M = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 64;
+    const double dup_ratio = argc > 2 ? std::strtod(argv[2], nullptr) : 0.25;
+
+    constexpr size_t MAX_L = 1'000'000;
+
+    std::mt19937_64 gen(42);
+    std::uniform_real_distribution<double> value_dist(0.0, 1.0);
+
+    std::printf("M=%zu duplicate_ratio=%.2f\n", M, dup_ratio);
+    std::printf("%10s %8s %14s %12s\n", "L", "reps", "ns/batch", "ns/elem");
+
+    for (size_t L = 10; L <= MAX_L; L *= 10) {
+        // Keys are drawn from a range smaller than L so that roughly dup_ratio of the batch are duplicates,
+        // as happens when several vertices of Ui relax the same neighbour.
+        const auto key_range = std::max<size_t>(1, static_cast<size_t>(static_cast<double>(L) * (1.0 - dup_ratio)));
+        std::uniform_int_distribution<size_t> key_dist(0, key_range - 1);
+        std::vector<Pair> batch;
+        batch.reserve(L);
+        for (size_t i = 0; i < L; ++i) {
+            batch.emplace_back(key_dist(gen), value_dist(gen));
+        }
+
+        const size_t reps = std::max<size_t>(3, 2'000'000 / L);
+        std::vector<Pair> work;
+        double total_ns = 0;
+        for (size_t r = 0; r < reps; ++r) {
+            DequeueBlocks D(key_range, M, 2.0);
+            work = batch;
+            const auto start = std::chrono::steady_clock::now();
+            D.batch_prepend(work, 1.0);
+            const auto end = std::chrono::steady_clock::now();
+            total_ns += std::chrono::duration<double, std::nano>(end - start).count();
+        }
+        const double per_batch = total_ns / static_cast<double>(reps);
+        std::printf("%10zu %8zu %14.0f %12.2f\n", L, reps, per_batch, per_batch / static_cast<double>(L));
+    }
+    return 0;
+}
@@ -0,0 +1,63 @@
+//
+// Wall-clock scaling of BMSSP with parallel find_pivots rounds on a random directed graph.
+// Usage: bmssp_scaling_bench [n] [avg_degree] [max_threads]
+// The defaults give 10^6 vertices and 10^7 edges. Every run must reproduce the single-threaded distances bit for bit.
+//
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "BMSSP.h"
+#include "Dijkstra.h"
+#include "GraphFactory.h"
+#include "Parallel.h"
+
+template <typename Fn>
+static double time_ms(Fn&& fn) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(const int argc, char** argv) {
+    const uint64_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    const double avg_degree = argc > 2 ? std::strtod(argv[2], nullptr) : 10.0;
+    const size_t max_threads = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : parallel::hardware_threads();
+
+    Graph g = random_graph(n, avg_degree);
+    const Vertex* src = g.get_vertex(0);
+    std::printf("n=%zu m=%zu max_threads=%zu\n", g.size(), g.edges_size(), max_threads);
+
+    std::vector<double> reference;
+    const double dijkstra_ms = time_ms([&] { reference = Dijkstra(g, src).fib_heap_run(); });
+    std::printf("%-10s %12.1f ms\n", "dijkstra", dijkstra_ms);
+
+    std::vector<double> serial;
+    double serial_ms = 0;
+    std::printf("%8s %12s %9s %8s\n", "threads", "ms", "speedup", "check");
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        std::vector<double> dist;
+        const double ms = time_ms([&] {
+            BMSSP bmssp(g, src);
+            bmssp.set_record_frames(false);
+            bmssp.set_threads(threads);
+            dist = bmssp.run();
+        });
+        if (threads == 1) {
+            serial = dist;
+            serial_ms = ms;
+        }
+        // Bitwise against the serial run, to 1e-6 against Dijkstra
+        bool ok = std::memcmp(dist.data(), serial.data(), dist.size() * sizeof(double)) == 0;
+        for (size_t i = 0; ok && i < dist.size(); ++i) {
+            ok = std::abs(dist[i] - reference[i]) <= 1e-6;
+        }
+        std::printf("%8zu %12.1f %9.2f %8s\n", threads, ms, serial_ms / ms, ok ? "ok" : "MISMATCH");
+    }
+    return 0;
+}
@@ -0,0 +1,64 @@
+//
+// Tuning mode for the BMSSP parameters (k, t). Sweeps them on a sample of sources, prints timings and operation
+// counts per point and stores the fastest pair in the profile file, where BMSSPTuner::tuned(graph, src) picks it up.
+// Usage: bmssp_tune grid <width> <height> [sources] [threads]
+//        bmssp_tune csv <file> <directed|undirected> [sources] [threads]
+//        bmssp_tune random <n> <avg_degree> [sources] [threads]
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "BMSSP.h"
+#include "BMSSPTuner.h"
+#include "GraphFactory.h"
+
+static int usage() {
+    std::fprintf(stderr, "usage: bmssp_tune grid <width> <height> [sources] [threads]\n"
+                         "       bmssp_tune csv <file> <directed|undirected> [sources] [threads]\n"
+                         "       bmssp_tune random <n> <avg_degree> [sources] [threads]\n");
+    return 1;
+}
+
+int main(const int argc, char** argv) {
+    if (argc < 4) return usage();
+    const std::string kind = argv[1];
+
+    Graph g(GraphType::DIRECTED);
+    if (kind == "grid") {
+        g = Graph(std::atoi(argv[2]), std::atoi(argv[3]));
+    } else if (kind == "csv") {
+        g = graph_from_csv(argv[2], std::strcmp(argv[3], "undirected") == 0 ? GraphType::UNDIRECTED : GraphType::DIRECTED);
+    } else if (kind == "random") {
+        g = random_graph(std::strtoull(argv[2], nullptr, 10), std::strtod(argv[3], nullptr));
+    } else {
+        return usage();
+    }
+    if (g.empty()) return usage();
+
+    const size_t sources = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 8;
+    const size_t threads = argc > 5 ? std::strtoul(argv[5], nullptr, 10) : 1;
+
+    const BMSSP defaults = BMSSPTuner::tuned(g, 0);
+    std::printf("%s\n", fingerprint(g).key().c_str());
+    std::printf("current k=%zu t=%zu, sweeping on %zu sources with %zu threads\n", defaults.k(), defaults.t(), sources,
+                threads);
+
+    BMSSPTuner tuner(g, sources, threads);
+    const TuningProfile best = tuner.sweep();
+
+    std::printf("%4s %4s %12s %12s %12s %12s %14s\n", "k", "t", "ms/source", "pulls", "base_cases", "pivot_rounds",
+                "relaxations");
+    for (const auto& [k, t, ms, c] : tuner.samples()) {
+        std::printf("%4zu %4zu %12.3f %12lu %12lu %12lu %14lu\n", k, t, ms, c.pulls, c.base_cases, c.pivot_rounds,
+                    c.relaxations);
+    }
+
+    BMSSPTuner::save(g, best);
+    const BMSSP tuned = BMSSPTuner::tuned(g, 0);
+    std::printf("best k=%zu t=%zu (%.3f ms/source), saved to %s, now picked up as k=%zu t=%zu\n", best.k, best.t,
+                best.ms, BMSSPTuner::profile_path().c_str(), tuned.k(), tuned.t());
+    return 0;
+}
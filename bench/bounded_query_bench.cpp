@@ -0,0 +1,81 @@
+//
+// Bounded-radius queries: cost of Dijkstra::bounded_run and BMSSP::bounded_run against the size of the region they
+// reach, next to a full std_heap_run. Radii are picked so that the balls around the sources hold roughly 10^2 .. 10^5
+// vertices. Both engines and the workspace are reused across all queries.
+// Usage: bounded_query_bench [n] [avg_degree] [sources]
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "BMSSP.h"
+#include "Dijkstra.h"
+#include "GraphFactory.h"
+#include "SparseDistances.h"
+
+template <typename Fn>
+static double time_ms(Fn&& fn) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(const int argc, char** argv) {
+    const uint64_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    const double avg_degree = argc > 2 ? std::strtod(argv[2], nullptr) : 4.0;
+    const size_t num_sources = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 5;
+
+    Graph g = random_graph(n, avg_degree);
+    const auto sources = get_start_vertices(g, static_cast<int>(std::min(num_sources, g.size())));
+    std::printf("n=%zu m=%zu, %zu sources\n", g.size(), g.edges_size(), sources.size());
+
+    // Full distances per source, for the radii, the reference results and the full-run timing
+    std::vector<std::vector<double>> full;
+    double full_ms = 0;
+    for (const Vertex* src : sources) {
+        Dijkstra dijkstra(g, src);
+        dijkstra.set_record_frames(false);
+        full_ms += time_ms([&] { full.push_back(dijkstra.std_heap_run()); });
+    }
+    full_ms /= static_cast<double>(sources.size());
+
+    SparseDistances ws(g.size());
+    BMSSP bmssp(g, sources.front());
+    bmssp.set_record_frames(false);
+    std::vector<double> sorted = full.front();
+    std::sort(sorted.begin(), sorted.end());
+    // The first bounded query allocates the per-level queue indices, keep it out of the timings
+    bmssp.bounded_run(sources.front(), sorted[std::min<size_t>(1000, g.size() - 1)]);
+    std::printf("%12s %10s %12s %12s %12s %6s\n", "radius", "reached", "dijkstra ms", "bmssp ms", "full ms", "check");
+    for (size_t target = 100; target < g.size(); target *= 10) {
+        const double B = sorted[target];
+        double dijkstra_ms = 0, bmssp_ms = 0;
+        size_t reached = 0;
+        bool ok = true;
+        for (size_t s = 0; s < sources.size(); ++s) {
+            std::vector<Pair> a, b;
+            dijkstra_ms += time_ms([&] { a = Dijkstra(g, sources[s]).bounded_run(B, ws); });
+            bmssp_ms += time_ms([&] { b = bmssp.bounded_run(sources[s], B); });
+            reached += a.size();
+
+            const auto expected = static_cast<size_t>(std::ranges::count_if(full[s], [B](const double d) {
+                return d < B;
+            }));
+            ok = ok and a.size() == expected and b.size() == expected;
+            for (const auto* result : {&a, &b}) {
+                for (const auto& [v, d] : *result) {
+                    ok = ok and std::abs(full[s][v] - d) <= 1e-9 * std::max(1.0, d);
+                }
+            }
+        }
+        const auto q = static_cast<double>(sources.size());
+        std::printf("%12.3f %10.0f %12.3f %12.3f %12.3f %6s\n", B, static_cast<double>(reached) / q,
+                    dijkstra_ms / q, bmssp_ms / q, full_ms, ok ? "ok" : "FAIL");
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+//
+// Effect of the constant-degree transformation on BMSSP for skewed out-degree distributions. For power-law graphs
+// of decreasing skew (and a uniform random graph for reference) it times BMSSP on the input graph and on its
+// reduction, and checks both against Dijkstra on the input graph.
+// Usage: degree_reduction_bench [n] [avg_degree] [max_degree] [sources]
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <vector>
+
+#include "BMSSP.h"
+#include "DegreeReduction.h"
+#include "Dijkstra.h"
+#include "GraphFactory.h"
+
+template <typename Fn>
+static double time_ms(Fn&& fn) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+static bool same(const std::vector<double>& a, const std::vector<double>& b) {
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::abs(a[i] - b[i]) > 1e-9 * std::max(1.0, std::abs(a[i]))) return false;
+    }
+    return a.size() == b.size();
+}
+
+static void run(const char* name, Graph& g, const size_t max_degree, const size_t sources) {
+    size_t top_degree = 0;
+    for (const auto& vertex : g.get_vertices()) {
+        top_degree = std::max(top_degree, vertex.outgoing_edges_.size());
+    }
+    std::optional<DegreeReduction> reduction;
+    const double transform_ms = time_ms([&] { reduction.emplace(g, max_degree); });
+    double plain_ms = 0, reduced_ms = 0;
+    uint64_t plain_relax = 0, reduced_relax = 0;
+    bool ok = true;
+    for (const Vertex* src : get_start_vertices(g, static_cast<int>(sources))) {
+        const auto reference = Dijkstra(g, src).fib_heap_run();
+
+        std::vector<double> dist;
+        BMSSP plain(g, src);
+        plain.set_record_frames(false);
+        plain_ms += time_ms([&] { dist = plain.run(); });
+        plain_relax += plain.counters().relaxations;
+        ok = ok and same(reference, dist);
+
+        BMSSP reduced(reduction->reduced(), reduction->vertex(src->id_));
+        reduced.set_record_frames(false);
+        reduced_ms += time_ms([&] { dist = reduction->distances(reduced.run()); });
+        reduced_relax += reduced.counters().relaxations;
+        ok = ok and same(reference, dist);
+    }
+    const auto s = static_cast<double>(sources);
+    std::printf("%-16s %9zu %10zu %10.1f %10.1f %10.1f %8.2fx %12.0f %12.0f %6s\n", name, top_degree,
+                reduction->proxies(), transform_ms, plain_ms / s, reduced_ms / s, plain_ms / reduced_ms,
+                static_cast<double>(plain_relax) / s, static_cast<double>(reduced_relax) / s, ok ? "ok" : "FAIL");
+}
+
+int main(const int argc, char** argv) {
+    const uint64_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200'000;
+    const double avg_degree = argc > 2 ? std::strtod(argv[2], nullptr) : 8.0;
+    const size_t max_degree = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 16;
+    const size_t sources = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 3;
+
+    std::printf("n=%zu avg_degree=%.1f max_degree=%zu, BMSSP ms and relaxations per source\n", n, avg_degree,
+                max_degree);
+    std::printf("%-16s %9s %10s %10s %10s %10s %9s %12s %12s %6s\n", "graph", "top_deg", "proxies", "transform",
+                "input", "reduced", "speedup", "relax_in", "relax_red", "check");
+    for (const double exponent : {1.8, 2.1, 2.5, 3.0}) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "power-law %.1f", exponent);
+        Graph g = power_law_graph(n, avg_degree, exponent);
+        run(name, g, max_degree, sources);
+    }
+    Graph uniform = random_graph(n, avg_degree);
+    run("uniform", uniform, max_degree, sources);
+    return 0;
+}
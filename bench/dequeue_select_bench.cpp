@@ -0,0 +1,109 @@
+//
+// Throughput of the DequeueBlocks selection paths in elements/ns.
+//  - select: select_kernels::select_kth with the scalar and the SIMD partition kernel, against std::nth_element on Pair
+//  - split:  selecting the median of an (M+1)-element block, the work done by DequeueBlocks::split
+//  - pull:   draining a DequeueBlocks filled with random keys through pull()
+// Usage: dequeue_select_bench [M]
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "BlockLinkedList.h"
+#include "SelectKernels.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsed_ns(const Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+// elements/ns of selecting the k-th pair out of n, averaged over reps fresh copies of the input
+static double bench_select(const std::vector<double>& values, const std::vector<uint64_t>& ids, const size_t k,
+                           const size_t reps, const select_kernels::PartitionFn part) {
+    const size_t n = values.size();
+    std::vector<double> v(n), sv(n);
+    std::vector<uint64_t> id(n), si(n);
+    double ns = 0;
+    for (size_t r = 0; r < reps; ++r) {
+        std::copy(values.begin(), values.end(), v.begin());
+        std::copy(ids.begin(), ids.end(), id.begin());
+        const auto start = Clock::now();
+        select_kernels::select_kth(v.data(), id.data(), n, k, sv.data(), si.data(), part);
+        ns += elapsed_ns(start);
+    }
+    return static_cast<double>(n * reps) / ns;
+}
+
+static double bench_nth_element(const std::vector<double>& values, const std::vector<uint64_t>& ids, const size_t k,
+                                const size_t reps) {
+    const size_t n = values.size();
+    std::vector<Pair> pairs(n);
+    double ns = 0;
+    for (size_t r = 0; r < reps; ++r) {
+        for (size_t i = 0; i < n; ++i) pairs[i] = Pair(ids[i], values[i]);
+        const auto start = Clock::now();
+        std::nth_element(pairs.begin(), pairs.begin() + static_cast<long>(k), pairs.end());
+        ns += elapsed_ns(start);
+    }
+    return static_cast<double>(n * reps) / ns;
+}
+
+int main(const int argc, char** argv) {
+    const size_t M = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 256;
+    std::mt19937_64 gen(42);
+    std::uniform_real_distribution<double> value_dist(0.0, 1000.0);
+
+    std::printf("isa=%s M=%zu\n\n", select_kernels::isa_name(), M);
+
+    std::printf("select (elements/ns)\n%10s %10s %10s %14s\n", "n", "scalar", "simd", "nth_element");
+    for (size_t n = 64; n <= (1u << 20); n *= 4) {
+        std::vector<double> values(n);
+        std::vector<uint64_t> ids(n);
+        for (size_t i = 0; i < n; ++i) values[i] = value_dist(gen);
+        std::iota(ids.begin(), ids.end(), 0);
+        std::ranges::shuffle(ids, gen);
+        const size_t reps = std::max<size_t>(5, (1u << 22) / n);
+        std::printf("%10zu %10.3f %10.3f %14.3f\n", n,
+                    bench_select(values, ids, n / 2, reps, select_kernels::partition_scalar),
+                    bench_select(values, ids, n / 2, reps, select_kernels::partition),
+                    bench_nth_element(values, ids, n / 2, reps));
+    }
+
+    {
+        const size_t n = M + 1;
+        std::vector<double> values(n);
+        std::vector<uint64_t> ids(n);
+        for (size_t i = 0; i < n; ++i) values[i] = value_dist(gen);
+        std::iota(ids.begin(), ids.end(), 0);
+        const size_t reps = std::max<size_t>(5, (1u << 22) / n);
+        std::printf("\nsplit of an (M+1)-block (elements/ns): scalar %.3f simd %.3f nth_element %.3f\n",
+                    bench_select(values, ids, n / 2, reps, select_kernels::partition_scalar),
+                    bench_select(values, ids, n / 2, reps, select_kernels::partition),
+                    bench_nth_element(values, ids, n / 2, reps));
+    }
+
+    std::printf("\npull (elements/ns)\n%10s %12s %12s\n", "N", "insert", "pull");
+    for (size_t N = 1u << 12; N <= (1u << 20); N *= 4) {
+        std::vector<uint64_t> keys(N);
+        std::iota(keys.begin(), keys.end(), 0);
+        std::ranges::shuffle(keys, gen);
+
+        DequeueBlocks D(N, M, 2000.0);
+        auto start = Clock::now();
+        for (const uint64_t key : keys) D.insert(key, value_dist(gen));
+        const double insert_ns = elapsed_ns(start);
+
+        size_t pulled = 0;
+        start = Clock::now();
+        while (!D.empty()) pulled += D.pull().first.size();
+        const double pull_ns = elapsed_ns(start);
+        std::printf("%10zu %12.4f %12.4f\n", N, static_cast<double>(N) / insert_ns, static_cast<double>(pulled) / pull_ns);
+    }
+    return 0;
+}
@@ -0,0 +1,75 @@
+//
+// Incremental repair of DynamicSSSP against a full recompute after batches of random edge weight changes (each
+// weight scaled by a factor in [0.5, 2)) on a random directed graph.
+// Usage: dynamic_sssp_bench [n] [avg_degree] [batch_size] [batches]
+//
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "Dijkstra.h"
+#include "DynamicSSSP.h"
+#include "GraphFactory.h"
+
+template <typename Fn>
+static double time_ms(Fn&& fn) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(const int argc, char** argv) {
+    const uint64_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    const double avg_degree = argc > 2 ? std::strtod(argv[2], nullptr) : 4.0;
+    const size_t batch_size = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 10;
+    const size_t batches = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 10;
+
+    Graph g = random_graph(n, avg_degree);
+    const Vertex* src = g.get_vertex(0);
+    std::printf("n=%zu m=%zu, %zu batches of %zu weight changes\n", g.size(), g.edges_size(), batches, batch_size);
+
+    std::optional<DynamicSSSP> dynamic;
+    const double init_ms = time_ms([&] { dynamic.emplace(g, src); });
+    std::printf("initial run %.1f ms\n", init_ms);
+
+    std::mt19937_64 gen(7);
+    std::uniform_int_distribution<uint64_t> vertex_dist(0, n - 1);
+    std::uniform_real_distribution<double> factor_dist(0.5, 2.0);
+
+    std::printf("%6s %10s %10s %12s %12s %12s %9s %6s\n", "batch", "affected", "touched", "touched/n", "repair ms",
+                "full ms", "speedup", "check");
+    for (size_t b = 0; b < batches; ++b) {
+        std::vector<EdgeUpdate> updates;
+        while (updates.size() < batch_size) {
+            const Vertex* u = g.get_vertex(vertex_dist(gen));
+            if (u->outgoing_edges_.empty()) continue;
+            const auto& edge = u->outgoing_edges_[gen() % u->outgoing_edges_.size()];
+            updates.push_back({u->id_, edge.to_id_, edge.weight_ * factor_dist(gen)});
+        }
+
+        RepairStats stats;
+        const double repair_ms = time_ms([&] { stats = dynamic->apply(updates); });
+        std::vector<double> full;
+        const double full_ms = time_ms([&] {
+            Dijkstra dijkstra(g, src);
+            dijkstra.set_record_frames(false);
+            full = dijkstra.std_heap_run();
+        });
+
+        bool ok = true;
+        const auto& dist = dynamic->distances();
+        for (size_t v = 0; v < full.size(); ++v) {
+            ok = ok and std::abs(full[v] - dist[v]) <= 1e-9 * std::max(1.0, full[v]);
+        }
+        std::printf("%6zu %10zu %10zu %12.6f %12.3f %12.3f %8.1fx %6s\n", b, stats.affected, stats.touched,
+                    static_cast<double>(stats.touched) / static_cast<double>(n), repair_ms, full_ms,
+                    full_ms / repair_ms, ok ? "ok" : "FAIL");
+    }
+    return 0;
+}
@@ -0,0 +1,91 @@
+//
+// Storage backends through the same engine code: BasicDijkstra<G> and BasicBMSSP<G> on a random graph held as Graph,
+// CSRGraph and a GraphSnapshot, and on a grid held as Graph, CSRGraph and GridGraph. Backends built from the same Graph
+// store the same arcs in the same order and must give bit-identical distances; GridGraph perturbs its weights itself
+// and is only checked against its own Dijkstra.
+// Usage: graph_backend_bench [n] [avg_degree] [side] [sources]
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "BMSSP.h"
+#include "CSRGraph.h"
+#include "Dijkstra.h"
+#include "GraphFactory.h"
+#include "GridGraph.h"
+#include "MutableGraph.h"
+
+template <typename Fn>
+static double time_ms(Fn&& fn) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Time both engines from every source and return the Dijkstra distances. reference, if given, is what Dijkstra must
+// reproduce exactly.
+template <SSSPGraph G>
+static std::vector<std::vector<double>> run_backend(const char* name, const G& graph,
+                                                    const std::vector<uint64_t>& sources,
+                                                    const std::vector<std::vector<double>>* reference) {
+    std::vector<std::vector<double>> result;
+    double dijkstra_ms = 0, bmssp_ms = 0;
+    bool ok = true;
+    for (const uint64_t src : sources) {
+        std::vector<double> a, b;
+        dijkstra_ms += time_ms([&] {
+            BasicDijkstra<G> dijkstra(graph, src);
+            dijkstra.set_record_frames(false);
+            a = dijkstra.std_heap_run();
+        });
+        bmssp_ms += time_ms([&] {
+            BasicBMSSP<G> bmssp(graph, src);
+            bmssp.set_record_frames(false);
+            b = bmssp.run();
+        });
+        for (size_t v = 0; v < a.size(); ++v) {
+            ok = ok and std::abs(a[v] - b[v]) <= 1e-9 * std::max(1.0, a[v]);
+        }
+        if (reference != nullptr) ok = ok and a == (*reference)[result.size()];
+        result.push_back(std::move(a));
+    }
+    const auto q = static_cast<double>(sources.size());
+    std::printf("%-14s %12.2f %12.2f %6s\n", name, dijkstra_ms / q, bmssp_ms / q, ok ? "ok" : "FAIL");
+    return result;
+}
+
+int main(const int argc, char** argv) {
+    const uint64_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 500'000;
+    const double avg_degree = argc > 2 ? std::strtod(argv[2], nullptr) : 4.0;
+    const auto side = static_cast<uint32_t>(argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 700);
+    const size_t num_sources = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 3;
+
+    {
+        const Graph g = random_graph(n, avg_degree);
+        std::vector<uint64_t> sources;
+        for (const Vertex* v : get_start_vertices(g, static_cast<int>(std::min(num_sources, g.size())))) {
+            sources.push_back(v->id_);
+        }
+        std::printf("random graph n=%zu m=%zu, %zu sources\n", g.size(), g.edges_size(), sources.size());
+        std::printf("%-14s %12s %12s %6s\n", "backend", "dijkstra ms", "bmssp ms", "check");
+        const auto reference = run_backend("Graph", g, sources, nullptr);
+        run_backend("CSRGraph", CSRGraph(g), sources, &reference);
+        const MutableGraph mutable_graph(g, 0, false);
+        run_backend("GraphSnapshot", *mutable_graph.snapshot(), sources, &reference);
+    }
+
+    const Graph g(static_cast<int>(side), static_cast<int>(side));
+    const std::vector<uint64_t> sources = {0, static_cast<uint64_t>(side / 2) * side + side / 2, g.size() - 1};
+    std::printf("\n%ux%u grid, corner, center and far corner sources\n", side, side);
+    std::printf("%-14s %12s %12s %6s\n", "backend", "dijkstra ms", "bmssp ms", "check");
+    const auto reference = run_backend("Graph", g, sources, nullptr);
+    run_backend("CSRGraph", CSRGraph(g), sources, &reference);
+    run_backend("GridGraph", GridGraph(side, side), sources, nullptr);
+    return 0;
+}
@@ -0,0 +1,100 @@
+//
+// Implicit grids: GridGraph against the adjacency lists of Graph(side, side), same engines, same cell ids. Reports the
+// resident memory each representation adds and the query time of Dijkstra and BMSSP on both. A second, Dijkstra only
+// run on a big GridGraph (10^7 cells by default) shows how far the implicit grid goes before the distance arrays are
+// all that is left; the peak resident memory of the process is printed at the end.
+// Usage: grid_graph_bench [side] [big_side]
+//
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "BMSSP.h"
+#include "Dijkstra.h"
+#include "GridGraph.h"
+
+template <typename Fn>
+static double time_ms(Fn&& fn) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// A "<field>: <n> kB" line of /proc/self/status in MiB, 0 where there is none
+static double status_mib(const std::string& field) {
+    std::ifstream f("/proc/self/status");
+    std::string key;
+    while (f >> key) {
+        if (key == field + ":") {
+            double kb = 0;
+            f >> kb;
+            return kb / 1024.0;
+        }
+        f.ignore(4096, '\n');
+    }
+    return 0;
+}
+
+template <typename G>
+static void run_engines(const char* name, G& graph, const uint64_t src, const double build_ms, const double mib) {
+    std::vector<double> a, b;
+    const double dijkstra_ms = time_ms([&] {
+        BasicDijkstra<G> dijkstra(graph, src);
+        dijkstra.set_record_frames(false);
+        a = dijkstra.std_heap_run();
+    });
+    const double bmssp_ms = time_ms([&] {
+        BasicBMSSP<G> bmssp(graph, src);
+        bmssp.set_record_frames(false);
+        b = bmssp.run();
+    });
+    bool ok = a.size() == b.size();
+    for (size_t v = 0; ok and v < a.size(); ++v) {
+        ok = std::abs(a[v] - b[v]) <= 1e-9 * std::max(1.0, a[v]);
+    }
+    std::printf("%-10s %10.1f %10.1f %12.1f %12.1f %6s\n", name, mib, build_ms, dijkstra_ms, bmssp_ms,
+                ok ? "ok" : "FAIL");
+}
+
+int main(const int argc, char** argv) {
+    const auto side = static_cast<uint32_t>(argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000);
+    const auto big_side = static_cast<uint32_t>(argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 3163);
+    const uint64_t center = static_cast<uint64_t>(side / 2) * side + side / 2;
+
+    std::printf("%ux%u grid, source in the center\n", side, side);
+    std::printf("%-10s %10s %10s %12s %12s %6s\n", "graph", "MiB", "build ms", "dijkstra ms", "bmssp ms", "check");
+    {
+        double before = status_mib("VmRSS");
+        std::optional<GridGraph> grid;
+        double build_ms = time_ms([&] { grid.emplace(side, side); });
+        run_engines("GridGraph", *grid, center, build_ms, status_mib("VmRSS") - before);
+
+        before = status_mib("VmRSS");
+        std::optional<Graph> graph;
+        build_ms = time_ms([&] { graph.emplace(static_cast<int>(side), static_cast<int>(side)); });
+        const double mib = status_mib("VmRSS") - before;
+        run_engines("Graph", *graph, center, build_ms, mib);
+    }
+
+    // No adjacency at all: the 8 bytes per cell of the distance array and the heap are the whole footprint
+    GridGraph big(big_side, big_side);
+    const uint64_t big_center = static_cast<uint64_t>(big_side / 2) * big_side + big_side / 2;
+    std::vector<double> dist;
+    const double big_ms = time_ms([&] {
+        BasicDijkstra<GridGraph> dijkstra(big, big_center);
+        dijkstra.set_record_frames(false);
+        dist = dijkstra.std_heap_run();
+    });
+    double farthest = 0;
+    for (const double d : dist) farthest = std::max(farthest, d);
+    std::printf("\n%ux%u = %zu cells, dijkstra %.1f ms, farthest %.3f, peak RSS %.1f MiB\n", big_side, big_side,
+                big.size(), big_ms, farthest, status_mib("VmHWM"));
+    return 0;
+}
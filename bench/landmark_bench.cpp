@@ -0,0 +1,99 @@
+//
+// ALT point-to-point queries against plain bidirectional Dijkstra, on an undirected grid and a directed random graph.
+// For every landmark strategy and table precision: preprocessing time, table memory, and the mean number of settled
+// vertices and wall clock per query over the same random s -> t pairs. Distances are checked against the baseline.
+// The last line per graph times the tables of one landmark set on 1 and on `threads` threads.
+// Usage: landmark_bench [side] [n] [landmarks] [queries] [threads]
+//
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "GraphFactory.h"
+#include "LandmarkIndex.h"
+#include "Parallel.h"
+
+template <typename Fn>
+static double time_ms(Fn&& fn) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+static void run(const char* name, const Graph& g, const size_t landmarks, const size_t queries, const size_t threads) {
+    std::mt19937_64 gen(5);
+    std::uniform_int_distribution<uint64_t> vertex_dist(0, g.size() - 1);
+    std::vector<std::pair<uint64_t, uint64_t>> pairs(queries);
+    for (auto& [s, t] : pairs) {
+        s = vertex_dist(gen);
+        t = vertex_dist(gen);
+    }
+    SparseDistances ws(g.size()), backward(g.size());
+
+    std::printf("%s: n=%zu m=%zu, %zu landmarks, %zu queries\n", name, g.size(), g.edges_size(), landmarks, queries);
+    std::printf("%-22s %10s %10s %12s %10s %9s %6s\n", "method", "build ms", "table MiB", "settled", "query ms",
+                "vs bidi", "check");
+
+    // Baseline, any index answers bidirectional queries; an empty landmark set costs nothing
+    const LandmarkIndex plain(g, std::vector<uint64_t>{});
+    std::vector<double> reference;
+    double base_settled = 0;
+    const double base_ms = time_ms([&] {
+        for (const auto& [s, t] : pairs) {
+            const auto r = plain.bidirectional_dijkstra(s, t, ws, backward);
+            reference.push_back(r.dist);
+            base_settled += static_cast<double>(r.settled);
+        }
+    });
+    const auto q = static_cast<double>(queries);
+    std::printf("%-22s %10s %10s %12.0f %10.3f %9s %6s\n", "bidirectional", "-", "-", base_settled / q, base_ms / q,
+                "1.00x", "");
+
+    std::vector<uint64_t> chosen;
+    for (const auto strategy : {LandmarkStrategy::Farthest, LandmarkStrategy::Avoid}) {
+        for (const auto precision : {LandmarkPrecision::Float32, LandmarkPrecision::UInt32}) {
+            const LandmarkIndex index(g, landmarks, strategy, precision, threads);
+            double settled = 0;
+            bool ok = true;
+            const double ms = time_ms([&] {
+                for (size_t i = 0; i < queries; ++i) {
+                    const auto r = index.query(pairs[i].first, pairs[i].second, ws);
+                    settled += static_cast<double>(r.settled);
+                    ok = ok and (r.dist == reference[i]
+                                 or std::abs(r.dist - reference[i]) <= 1e-9 * std::max(1.0, reference[i]));
+                }
+            });
+            char method[32];
+            std::snprintf(method, sizeof(method), "alt %s %s",
+                          strategy == LandmarkStrategy::Farthest ? "farthest" : "avoid",
+                          precision == LandmarkPrecision::Float32 ? "f32" : "u32");
+            std::printf("%-22s %10.1f %10.2f %12.0f %10.3f %8.2fx %6s\n", method, index.build_ms(),
+                        static_cast<double>(index.bytes()) / (1024.0 * 1024.0), settled / q, ms / q,
+                        base_settled / std::max(settled, 1.0), ok ? "ok" : "FAIL");
+            chosen = index.landmarks();
+        }
+    }
+
+    const LandmarkIndex serial(g, chosen, LandmarkPrecision::Float32, 1);
+    const LandmarkIndex parallel(g, chosen, LandmarkPrecision::Float32, threads);
+    std::printf("tables of %zu landmarks: %.1f ms on 1 thread, %.1f ms on %zu\n\n", chosen.size(), serial.build_ms(),
+                parallel.build_ms(), std::min(threads, parallel::hardware_threads()));
+}
+
+int main(const int argc, char** argv) {
+    const int side = argc > 1 ? std::atoi(argv[1]) : 500;
+    const uint64_t n = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 200'000;
+    const size_t landmarks = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 16;
+    const size_t queries = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 200;
+    const size_t threads = argc > 5 ? std::strtoul(argv[5], nullptr, 10) : parallel::hardware_threads();
+
+    run("grid", Graph(side, side), landmarks, queries, threads);
+    run("random", random_graph(n, 4.0), landmarks, queries, threads);
+    return 0;
+}
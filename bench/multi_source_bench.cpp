@@ -0,0 +1,82 @@
+//
+// Throughput of MultiSourceSSSP (8 and 16 lanes) against one std_heap_run per source, in source-queries per second,
+// on a random graph, a power-law graph and a grid, all in CSR form. Both paths split the sources over the same
+// threads. Distances must be identical; scans/n is how often the multi-source engine scanned a vertex on average.
+// Usage: multi_source_bench [n] [side] [sources] [threads]
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "CSRGraph.h"
+#include "Dijkstra.h"
+#include "GraphFactory.h"
+#include "MinPlusKernels.h"
+#include "MultiSourceSSSP.h"
+#include "Parallel.h"
+
+template <typename Fn>
+static double time_ms(Fn&& fn) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+template <size_t Lanes>
+static void run_lanes(const CSRGraph& g, const std::vector<uint64_t>& sources, const size_t threads,
+                      const std::vector<std::vector<double>>& reference) {
+    std::vector<std::vector<double>> result;
+    const double ms = time_ms([&] { result = multi_source_distances<CSRGraph, Lanes>(g, sources, threads); });
+    MultiSourceSSSP<CSRGraph, Lanes> engine(g);
+    engine.run(std::span(sources).first(std::min(Lanes, sources.size())));
+    const auto& stats = engine.stats();
+    char name[32];
+    std::snprintf(name, sizeof(name), "multi-source x%zu", Lanes);
+    std::printf("%-18s %10.1f %12.1f %8lu %8.2f %6s\n", name, ms, 1000.0 * static_cast<double>(sources.size()) / ms,
+                stats.rounds, static_cast<double>(stats.scans) / static_cast<double>(g.size()),
+                result == reference ? "ok" : "FAIL");
+}
+
+static void run(const char* name, const Graph& graph, const size_t num_sources, const size_t threads) {
+    const CSRGraph g(graph);
+    std::vector<uint64_t> sources;
+    for (size_t i = 0; i < num_sources; ++i) {
+        sources.push_back(i * 7919 % g.size());
+    }
+    std::printf("%s: n=%zu m=%zu, %zu sources\n", name, g.size(), g.arcs(), sources.size());
+    std::printf("%-18s %10s %12s %8s %8s %6s\n", "engine", "ms", "queries/s", "rounds", "scans/n", "check");
+
+    std::vector<std::vector<double>> reference(sources.size());
+    const double ms = time_ms([&] {
+        parallel::parallel_for(sources.size(), threads, [&](const size_t begin, const size_t end, size_t) {
+            for (size_t i = begin; i < end; ++i) {
+                BasicDijkstra<CSRGraph> dijkstra(g, sources[i]);
+                dijkstra.set_record_frames(false);
+                reference[i] = dijkstra.std_heap_run();
+            }
+        });
+    });
+    std::printf("%-18s %10.1f %12.1f %8s %8s %6s\n", "std_heap_run", ms,
+                1000.0 * static_cast<double>(sources.size()) / ms, "-", "-", "");
+    run_lanes<8>(g, sources, threads, reference);
+    run_lanes<16>(g, sources, threads, reference);
+    std::printf("\n");
+}
+
+int main(const int argc, char** argv) {
+    const uint64_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200'000;
+    const int side = argc > 2 ? std::atoi(argv[2]) : 400;
+    const size_t sources = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 64;
+    const size_t threads = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : parallel::hardware_threads();
+
+    std::printf("min-plus kernel: %s, %zu threads\n\n", min_plus::isa_name(),
+                std::min(threads, parallel::hardware_threads()));
+    run("random", random_graph(n, 4.0), sources, threads);
+    run("power law", power_law_graph(n, 6.0), sources, threads);
+    run("grid", Graph(side, side), sources, threads);
+    return 0;
+}
@@ -0,0 +1,185 @@
+//
+// Query slowdown and batch cost of MutableGraph as a function of overlay size, queries running against a concurrent
+// stream of mutations with background compaction, and manual compactions racing the background ones under that
+// stream: the final graph has to match the same mutations applied to plain adjacency lists.
+// Usage: mutable_graph_bench [n] [avg_degree] [seconds]
+//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "Dijkstra.h"
+#include "GraphFactory.h"
+#include "MutableGraph.h"
+
+template <typename Fn>
+static double time_ms(Fn&& fn) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// A mix of weight updates, inserts and deletes on random vertices
+static std::vector<EdgeOp> random_batch(std::mt19937_64& gen, const uint64_t n, const size_t size) {
+    std::uniform_int_distribution<uint64_t> vertex_dist(0, n - 1);
+    std::uniform_real_distribution<double> weight_dist(1.0, 100.0);
+    std::vector<EdgeOp> ops;
+    ops.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+        const uint64_t from = vertex_dist(gen);
+        const uint64_t to = vertex_dist(gen);
+        switch (gen() % 3) {
+            case 0: ops.push_back({EdgeOpType::Insert, from, to, weight_dist(gen)}); break;
+            case 1: ops.push_back({EdgeOpType::Delete, from, (from + 1) % n}); break;
+            default: ops.push_back({EdgeOpType::SetWeight, from, (from + 1) % n, weight_dist(gen)}); break;
+        }
+    }
+    return ops;
+}
+
+// The semantics of MutableGraph::apply on plain adjacency lists
+static void apply_reference(std::vector<std::vector<Edge>>& adjacency, const std::vector<EdgeOp>& ops) {
+    for (const auto& [type, from, to, weight] : ops) {
+        auto& edges = adjacency[from];
+        switch (type) {
+            case EdgeOpType::Insert: edges.emplace_back(to, weight); break;
+            case EdgeOpType::Delete: std::erase_if(edges, [to](const Edge& e) { return e.to_id_ == to; }); break;
+            case EdgeOpType::SetWeight:
+                for (auto& e : edges) {
+                    if (e.to_id_ == to) e.weight_ = weight;
+                }
+                break;
+        }
+    }
+}
+
+static bool same_adjacency(const GraphSnapshot& snapshot, const std::vector<std::vector<Edge>>& adjacency) {
+    for (uint64_t v = 0; v < adjacency.size(); ++v) {
+        const auto edges = snapshot.neighbors(v);
+        if (!std::ranges::equal(edges, adjacency[v], [](const Edge& a, const Edge& b) {
+            return a.to_id_ == b.to_id_ and a.weight_ == b.weight_;
+        })) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static std::vector<double> snapshot_dijkstra(const GraphSnapshot& snapshot, const uint64_t src) {
+    BasicDijkstra<GraphSnapshot> dijkstra(snapshot, src);
+    dijkstra.set_record_frames(false);
+    return dijkstra.std_heap_run();
+}
+
+static double query_ms(const GraphSnapshot& snapshot, const std::vector<uint64_t>& sources) {
+    return time_ms([&] {
+        for (const uint64_t src : sources) {
+            snapshot_dijkstra(snapshot, src);
+        }
+    }) / static_cast<double>(sources.size());
+}
+
+int main(const int argc, char** argv) {
+    const uint64_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 500'000;
+    const double avg_degree = argc > 2 ? std::strtod(argv[2], nullptr) : 8.0;
+    const double seconds = argc > 3 ? std::strtod(argv[3], nullptr) : 3.0;
+
+    const Graph g = random_graph(n, avg_degree);
+    const std::vector<uint64_t> sources = {0, n / 3, 2 * n / 3};
+    std::mt19937_64 gen(11);
+    std::printf("n=%zu m=%zu\n", g.size(), g.edges_size());
+
+    {
+        MutableGraph graph(g, n + 1, false);
+        const double base_ms = query_ms(*graph.snapshot(), sources);
+        std::printf("%10s %10s %12s %10s %12s %12s %12s\n", "overlay", "fraction", "query ms", "slowdown", "apply us",
+                    "compact ms", "after ms");
+        std::printf("%10d %10.4f %12.2f %9.2fx\n", 0, 0.0, base_ms, 1.0);
+        for (const double fraction : {0.001, 0.01, 0.05, 0.2, 0.5}) {
+            const auto target = static_cast<size_t>(fraction * static_cast<double>(n));
+            while (graph.snapshot()->overlay_size() < target) {
+                graph.apply(random_batch(gen, n, std::min<size_t>(1000, target)));
+            }
+            // Cost of publishing a batch of 100 ops on top of this overlay
+            std::vector<std::vector<EdgeOp>> batches(20);
+            for (auto& batch : batches) batch = random_batch(gen, n, 100);
+            const double apply_us = time_ms([&] {
+                for (const auto& batch : batches) graph.apply(batch);
+            }) * 1e3 / static_cast<double>(batches.size());
+            const auto before = graph.snapshot();
+            const double ms = query_ms(*before, sources);
+            const double compact_ms = time_ms([&] { graph.compact(); });
+            const auto after = graph.snapshot();
+            const double after_ms = query_ms(*after, sources);
+            const bool same = snapshot_dijkstra(*before, 0) == snapshot_dijkstra(*after, 0);
+            std::printf("%10zu %10.4f %12.2f %9.2fx %12.2f %12.2f %12.2f %s\n", before->overlay_size(),
+                        static_cast<double>(before->overlay_size()) / static_cast<double>(n), ms, ms / base_ms,
+                        apply_us, compact_ms, after_ms, same ? "" : "MISMATCH");
+        }
+    }
+
+    // Readers never block on the writer: every query runs on the snapshot it started with
+    MutableGraph graph(g);
+    std::atomic<bool> stop = false;
+    std::atomic<uint64_t> batches = 0;
+    std::jthread writer([&] {
+        std::mt19937_64 writer_gen(13);
+        while (!stop.load()) {
+            graph.apply(random_batch(writer_gen, n, 100));
+            batches.fetch_add(1);
+        }
+    });
+    size_t queries = 0;
+    double worst_ms = 0, total_ms = 0;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(seconds);
+    while (std::chrono::steady_clock::now() < deadline) {
+        const auto snapshot = graph.snapshot();
+        const double ms = time_ms([&] { snapshot_dijkstra(*snapshot, sources[queries % sources.size()]); });
+        worst_ms = std::max(worst_ms, ms);
+        total_ms += ms;
+        ++queries;
+    }
+    stop = true;
+    writer.join();
+    std::printf("concurrent: %zu queries (mean %.2f ms, worst %.2f ms), %lu batches of 100 ops, %lu compactions, "
+                "final overlay %zu\n", queries, total_ms / static_cast<double>(queries), worst_ms, batches.load(),
+                graph.compactions(), graph.snapshot()->overlay_size());
+
+    // A small threshold keeps the background compactor busy while another thread calls compact() back to back
+    MutableGraph raced(g, 64);
+    std::vector<std::vector<Edge>> reference(n);
+    for (uint64_t v = 0; v < n; ++v) {
+        const auto edges = raced.snapshot()->neighbors(v);
+        reference[v].assign(edges.begin(), edges.end());
+    }
+    stop = false;
+    std::atomic<uint64_t> manual = 0;
+    std::jthread compactor([&] {
+        while (!stop.load()) {
+            raced.compact();
+            manual.fetch_add(1);
+        }
+    });
+    std::mt19937_64 race_gen(17);
+    size_t race_batches = 0;
+    const auto race_deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(seconds);
+    while (std::chrono::steady_clock::now() < race_deadline) {
+        const auto ops = random_batch(race_gen, n, 100);
+        raced.apply(ops);
+        apply_reference(reference, ops);
+        ++race_batches;
+    }
+    stop = true;
+    compactor.join();
+    const bool ok = same_adjacency(*raced.snapshot(), reference);
+    std::printf("compaction race: %zu batches of 100 ops, %lu manual compact() calls, %lu compactions %s\n",
+                race_batches, manual.load(), raced.compactions(), ok ? "ok" : "FAIL");
+    return 0;
+}
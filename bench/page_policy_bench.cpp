@@ -0,0 +1,136 @@
+//
+// Page size and NUMA placement of the large arrays (PageAllocator.h) against the default allocator. One random graph
+// is built as Graph, then for every policy a CSRGraph is built from it and std_heap_run, fib_heap_run and BMSSP run
+// from each source and multi_source_distances from all of them, on `threads` threads where the engine has them. Engine
+// times are means per source, the build and the multi-source run are timed once; "vs default" is the summed time of
+// the default policy over that of the row. Distances must be bit-identical to the default row.
+// "thp MiB" is AnonHugePages of the process after the runs with the CSRGraph still alive, the memory that actually
+// sits in transparent huge pages; "fallbacks" are MAP_HUGETLB requests that found the huge page pool empty and fell
+// back to transparent huge pages (reserve some with vm.nr_hugepages). Interleave and first-touch only differ from the
+// default on machines with more than one NUMA node.
+// Usage: page_policy_bench [n] [avg_degree] [sources] [threads]
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "BMSSP.h"
+#include "CSRGraph.h"
+#include "Dijkstra.h"
+#include "GraphFactory.h"
+#include "MultiSourceSSSP.h"
+#include "PageAllocator.h"
+#include "Parallel.h"
+
+template <typename Fn>
+static double time_ms(Fn&& fn) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+static double anon_huge_mib() {
+    // The first line is the [rollup] address range, the totals follow as "Key: value kB"
+    std::ifstream in("/proc/self/smaps_rollup");
+    std::string line;
+    double kib = 0;
+    while (std::getline(in, line)) {
+        if (std::sscanf(line.c_str(), "AnonHugePages: %lf kB", &kib) == 1) return kib / 1024;
+    }
+    return 0;
+}
+
+struct Row {
+    double build = 0, std_heap = 0, fib_heap = 0, bmssp = 0, multi = 0;
+
+    [[nodiscard]] double total() const {
+        return build + std_heap + fib_heap + bmssp + multi;
+    }
+};
+
+int main(const int argc, char** argv) {
+    const uint64_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2'000'000;
+    const double avg_degree = argc > 2 ? std::strtod(argv[2], nullptr) : 4.0;
+    const size_t num_sources = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 4;
+    const size_t threads = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : parallel::hardware_threads();
+
+    const Graph g = random_graph(n, avg_degree);
+    std::vector<uint64_t> sources;
+    for (const Vertex* v : get_start_vertices(g, static_cast<int>(std::min(num_sources, g.size())))) {
+        sources.push_back(v->id_);
+    }
+    std::printf("random graph n=%zu m=%zu, %zu sources, %zu threads, %zu NUMA nodes\n", g.size(), g.edges_size(),
+                sources.size(), threads, pages::numa_nodes());
+    std::printf("%-11s %-11s %9s %9s %9s %9s %9s %10s %9s %9s %6s\n", "pages", "placement", "build ms", "std ms",
+                "fib ms", "bmssp ms", "multi ms", "vs default", "thp MiB", "fallbacks", "check");
+
+    using pages::PageSize, pages::Placement;
+    const pages::Policy policies[] = {
+        {PageSize::Default, Placement::Default},      {PageSize::Transparent, Placement::Default},
+        {PageSize::Huge2M, Placement::Default},       {PageSize::Huge1G, Placement::Default},
+        {PageSize::Default, Placement::Interleave},   {PageSize::Transparent, Placement::Interleave},
+        {PageSize::Default, Placement::FirstTouch},   {PageSize::Transparent, Placement::FirstTouch},
+    };
+    std::vector<std::vector<double>> reference;
+    double default_total = 0;
+    for (const pages::Policy policy : policies) {
+        pages::set_policy(policy);
+        const uint64_t fallbacks = pages::stats().fallbacks;
+        Row row;
+        std::optional<CSRGraph> csr;
+        row.build = time_ms([&] { csr.emplace(g); });
+
+        bool ok = true;
+        std::vector<std::vector<double>> results;
+        for (const uint64_t src : sources) {
+            std::vector<double> a, b, c;
+            row.std_heap += time_ms([&] {
+                BasicDijkstra<CSRGraph> dijkstra(*csr, src);
+                dijkstra.set_record_frames(false);
+                a = dijkstra.std_heap_run();
+            });
+            row.fib_heap += time_ms([&] { b = BasicDijkstra<CSRGraph>(*csr, src).fib_heap_run(); });
+            row.bmssp += time_ms([&] {
+                BasicBMSSP<CSRGraph> bmssp(*csr, src);
+                bmssp.set_record_frames(false);
+                bmssp.set_threads(threads);
+                c = bmssp.run();
+            });
+            ok = ok and a == b;
+            for (size_t v = 0; v < a.size(); ++v) {
+                ok = ok and std::abs(a[v] - c[v]) <= 1e-9 * std::max(1.0, a[v]);
+            }
+            results.push_back(std::move(a));
+        }
+        std::vector<std::vector<double>> multi;
+        row.multi = time_ms([&] { multi = multi_source_distances<CSRGraph>(*csr, sources, threads); });
+        for (size_t i = 0; i < sources.size(); ++i) {
+            for (size_t v = 0; v < results[i].size(); ++v) {
+                ok = ok and std::abs(results[i][v] - multi[i][v]) <= 1e-9 * std::max(1.0, results[i][v]);
+            }
+        }
+        if (reference.empty()) {
+            reference = results;
+            default_total = row.total();
+        }
+        ok = ok and results == reference;
+
+        const auto q = static_cast<double>(sources.size());
+        std::printf("%-11s %-11s %9.1f %9.1f %9.1f %9.1f %9.1f %9.2fx %9.1f %9lu %6s\n",
+                    pages::page_size_name(policy.size), pages::placement_name(policy.placement), row.build,
+                    row.std_heap / q, row.fib_heap / q, row.bmssp / q, row.multi, default_total / row.total(),
+                    anon_huge_mib(),
+                    pages::stats().fallbacks - fallbacks, ok ? "ok" : "FAIL");
+        std::fflush(stdout);
+    }
+    pages::set_policy({});
+    return 0;
+}
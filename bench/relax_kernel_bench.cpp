@@ -0,0 +1,167 @@
+//
+// The relaxation kernels of RelaxKernels.h on large graphs. The settle order of one Dijkstra run, each vertex with its
+// final distance, is recorded and replayed with nothing but the arc relaxations, so every variant meets the same
+// random dist accesses as the engines do without the heap operations around them:
+//   scalar      relax_scalar, the plain loop the engines used to run
+//   prefetched  for_each_prefetched with the same test, dist[v] fetched a group ahead
+//   grouped     relax, prefetch plus the vector group test (isa below) for adjacencies of MIN_GROUPED arcs and more
+// Every variant has to lower exactly as many entries to the same final distances. Times are the best of `reps`
+// replays in ns per arc; misses and branch misses per arc come from perf_event_open and read n/a where it is not
+// allowed. The engines are timed afterwards on the same graph, for comparing builds (ENABLE_NATIVE_ARCH=OFF leaves
+// them with the scalar group test).
+// Usage: relax_kernel_bench [n] [avg_degree] [reps]
+//
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <limits>
+#include <queue>
+#include <vector>
+
+#include "BMSSP.h"
+#include "CSRGraph.h"
+#include "Dijkstra.h"
+#include "GraphFactory.h"
+#include "PerfCounters.h"
+#include "RelaxKernels.h"
+
+template <typename Fn>
+static double time_ms(Fn&& fn) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Settled vertices in order with their distances
+static std::vector<Pair> settle_order(const CSRGraph& g, const uint64_t src) {
+    std::vector<double> dist(g.size(), std::numeric_limits<double>::infinity());
+    std::vector<Pair> order;
+    std::priority_queue<Pair, std::vector<Pair>, std::greater<>> pq;
+    dist[src] = 0;
+    pq.emplace(src, 0.0);
+    while (!pq.empty()) {
+        const auto [u, d_u] = pq.top();
+        pq.pop();
+        if (d_u != dist[u]) continue;
+        order.emplace_back(u, d_u);
+        for (const auto& [v, w] : g.neighbors(u)) {
+            if (d_u + w < dist[v]) {
+                dist[v] = d_u + w;
+                pq.emplace(v, dist[v]);
+            }
+        }
+    }
+    return order;
+}
+
+enum class Variant {Scalar, Prefetched, Grouped};
+
+struct Replay {
+    std::vector<double> dist;
+    uint64_t lowered = 0;
+    double ms = std::numeric_limits<double>::infinity();
+    perf::Sample sample;
+};
+
+// One replay; best keeps the fastest so far
+static void replay(const CSRGraph& g, const std::vector<Pair>& order, const Variant variant, Replay& best) {
+    constexpr double INF = std::numeric_limits<double>::infinity();
+    std::vector<double> dist(g.size(), INF);
+    dist[order.front().key_] = 0;
+    uint64_t lowered = 0;
+    const auto lower = [&](const uint64_t v, const double cand) {
+        dist[v] = cand;
+        ++lowered;
+    };
+    perf::reset();
+    const double ms = time_ms([&] {
+        const perf::Scope scope(perf::Phase::Relax);
+        for (const auto& [u, d_u] : order) {
+            switch (variant) {
+                case Variant::Scalar:
+                    relax_kernels::relax_scalar<false>(g.neighbors(u), d_u, INF, dist.data(), lower);
+                    break;
+                case Variant::Prefetched:
+                    relax_kernels::for_each_prefetched(
+                        g.neighbors(u), [&](const uint64_t v) { relax_kernels::prefetch(dist.data() + v); },
+                        [&](const uint64_t v, const double w) {
+                            if (d_u + w < dist[v]) lower(v, d_u + w);
+                        });
+                    break;
+                case Variant::Grouped:
+                    relax_kernels::relax<false>(g.neighbors(u), d_u, INF, dist.data(), lower);
+                    break;
+            }
+        }
+    });
+    if (ms < best.ms) {
+        best = {std::move(dist), lowered, ms, perf::totals()[static_cast<size_t>(perf::Phase::Relax)]};
+    }
+}
+
+static void run(const char* name, const Graph& graph, const size_t reps) {
+    const CSRGraph g(graph);
+    const uint64_t src = get_start_vertices(graph, 1).front()->id_;
+    const std::vector<Pair> order = settle_order(g, src);
+    uint64_t arcs = 0;
+    for (const auto& [u, d_u] : order) arcs += g.neighbors(u).size();
+
+    std::printf("%s: n=%zu m=%zu, %zu settled, %lu arcs relaxed, isa %s\n", name, g.size(), g.arcs(), order.size(),
+                arcs, relax_kernels::isa_name());
+    std::printf("  %-11s %10s %9s %8s %13s %16s %6s\n", "kernel", "ms", "ns/arc", "speedup", "misses/arc",
+                "br misses/arc", "check");
+    constexpr Variant VARIANTS[] = {Variant::Scalar, Variant::Prefetched, Variant::Grouped};
+    // Variants take turns, so that a machine getting slower or faster meanwhile does not favour one of them
+    Replay results[std::size(VARIANTS)];
+    for (size_t r = 0; r < reps; ++r) {
+        for (size_t i = 0; i < std::size(VARIANTS); ++i) replay(g, order, VARIANTS[i], results[i]);
+    }
+    const Replay& scalar = results[0];
+    for (size_t i = 0; i < std::size(VARIANTS); ++i) {
+        const Variant variant = VARIANTS[i];
+        const Replay& result = results[i];
+        const bool ok = result.lowered == scalar.lowered and result.dist == scalar.dist;
+        const char* kernel = variant == Variant::Scalar ? "scalar" : variant == Variant::Prefetched ? "prefetched"
+                                                                                                    : "grouped";
+        const auto per_arc = [&](const uint64_t count) {
+            return static_cast<double>(count) / static_cast<double>(arcs);
+        };
+        if (perf::counters_available()) {
+            std::printf("  %-11s %10.1f %9.2f %7.2fx %13.3f %16.3f %6s\n", kernel, result.ms, result.ms * 1e6 / arcs,
+                        scalar.ms / result.ms, per_arc(result.sample.cache_misses),
+                        per_arc(result.sample.branch_misses), ok ? "ok" : "FAIL");
+        } else {
+            std::printf("  %-11s %10.1f %9.2f %7.2fx %13s %16s %6s\n", kernel, result.ms, result.ms * 1e6 / arcs,
+                        scalar.ms / result.ms, "n/a", "n/a", ok ? "ok" : "FAIL");
+        }
+    }
+
+    BasicDijkstra<CSRGraph> dijkstra(g, src);
+    dijkstra.set_record_frames(false);
+    std::vector<double> a, b, c;
+    const double std_ms = time_ms([&] { a = dijkstra.std_heap_run(); });
+    const double fib_ms = time_ms([&] { b = dijkstra.fib_heap_run(); });
+    BasicBMSSP<CSRGraph> bmssp(g, src);
+    bmssp.set_record_frames(false);
+    const double bmssp_ms = time_ms([&] { c = bmssp.run(); });
+    bool ok = a == scalar.dist and b == scalar.dist;
+    for (size_t v = 0; v < a.size(); ++v) {
+        ok = ok and std::abs(a[v] - c[v]) <= 1e-9 * std::max(1.0, a[v]);
+    }
+    std::printf("  engines: std_heap_run %.1f ms, fib_heap_run %.1f ms, bmssp %.1f ms %s\n\n", std_ms, fib_ms,
+                bmssp_ms, ok ? "ok" : "FAIL");
+}
+
+int main(const int argc, char** argv) {
+    const uint64_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4'000'000;
+    const double avg_degree = argc > 2 ? std::strtod(argv[2], nullptr) : 4.0;
+    const size_t reps = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 3;
+
+    run("random", random_graph(n, avg_degree), reps);
+    run("power-law", power_law_graph(n, avg_degree), reps);
+    return 0;
+}
@@ -0,0 +1,122 @@
+//
+// ResultCache in front of heap Dijkstra on a stream of queries whose sources follow a Zipf distribution over a set
+// of depots, as get_start_vertices models them. Reports hit rate, mean query latency and memory for a few budgets and
+// both precisions, then changes an edge weight to show the invalidation, and finally runs the stream on several
+// threads sharing one cache.
+// Usage: result_cache_bench [n] [avg_degree] [queries] [threads]
+//
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "Dijkstra.h"
+#include "GraphFactory.h"
+#include "ResultCache.h"
+
+static constexpr int DEPOTS = 64;
+
+template <typename Fn>
+static double time_ms(Fn&& fn) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Depot indices with P(i) ~ 1 / (i + 1)
+static std::vector<size_t> zipf_stream(const size_t queries, const uint64_t seed) {
+    std::vector<double> weights(DEPOTS);
+    for (size_t i = 0; i < weights.size(); ++i) {
+        weights[i] = 1.0 / static_cast<double>(i + 1);
+    }
+    std::discrete_distribution<size_t> dist(weights.begin(), weights.end());
+    std::mt19937_64 gen(seed);
+    std::vector<size_t> stream(queries);
+    for (auto& q : stream) {
+        q = dist(gen);
+    }
+    return stream;
+}
+
+static std::vector<double> query(Graph& g, const Vertex* src) {
+    Dijkstra dijkstra(g, src);
+    dijkstra.set_record_frames(false);
+    return dijkstra.std_heap_run();
+}
+
+static void run_stream(Graph& g, ResultCache& cache, const std::vector<const Vertex*>& depots,
+                       const std::vector<size_t>& stream) {
+    for (const size_t d : stream) {
+        const Vertex* src = depots[d];
+        cache.dense({g.version(), src->id_}, [&] { return query(g, src); });
+    }
+}
+
+int main(const int argc, char** argv) {
+    const uint64_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200'000;
+    const double avg_degree = argc > 2 ? std::strtod(argv[2], nullptr) : 4.0;
+    const size_t queries = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 500;
+    const size_t threads = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 4;
+
+    Graph g = random_graph(n, avg_degree);
+    const auto depots = get_start_vertices(g, DEPOTS);
+    const auto stream = zipf_stream(queries, 1);
+    std::printf("n=%zu m=%zu, %zu queries over %d depots\n", g.size(), g.edges_size(), queries, DEPOTS);
+
+    const double uncached_ms = time_ms([&] {
+        for (size_t i = 0; i < std::min<size_t>(queries, 20); ++i) {
+            query(g, depots[stream[i]]);
+        }
+    }) / static_cast<double>(std::min<size_t>(queries, 20));
+    std::printf("uncached %.2f ms/query\n", uncached_ms);
+
+    std::printf("%10s %8s %10s %10s %10s %12s %12s\n", "precision", "budget", "hit rate", "ms/query", "entries",
+                "MiB", "max err");
+    const auto reference = query(g, depots[0]);
+    for (const auto precision : {CachePrecision::Float32, CachePrecision::Float64}) {
+        for (const size_t budget_results : {4, 16, 64}) {
+            const size_t budget = budget_results * n * (precision == CachePrecision::Float32 ? 4 : 8);
+            ResultCache cache(budget, precision);
+            const double ms = time_ms([&] { run_stream(g, cache, depots, stream); }) / static_cast<double>(queries);
+            const CacheStats s = cache.stats();
+
+            double max_err = 0;
+            const auto cached = cache.dense({g.version(), depots[0]->id_}, [&] { return reference; });
+            for (size_t v = 0; v < n; ++v) {
+                max_err = std::max(max_err, std::abs(cached[v] - reference[v]) / std::max(1.0, reference[v]));
+            }
+            std::printf("%10s %8zu %9.1f%% %10.2f %10zu %12.1f %12.2e\n",
+                        precision == CachePrecision::Float32 ? "float32" : "float64", budget_results,
+                        100.0 * static_cast<double>(s.hits) / static_cast<double>(s.hits + s.misses), ms, s.entries,
+                        static_cast<double>(s.bytes) / (1 << 20), max_err);
+        }
+    }
+
+    // A weight change moves the graph to a new version, the next lookup drops every older entry
+    ResultCache cache(64 * n * sizeof(double));
+    run_stream(g, cache, depots, stream);
+    const CacheStats before = cache.stats();
+    const Vertex* u = depots[0];
+    g.set_edge_weight(u->id_, u->outgoing_edges_.front().to_id_, 1.0);
+    run_stream(g, cache, depots, stream);
+    const CacheStats after = cache.stats();
+    std::printf("after a weight change: %lu invalidations, %lu misses (%lu before)\n",
+                after.invalidations - before.invalidations, after.misses - before.misses, before.misses);
+
+    ResultCache shared(64 * n * sizeof(double));
+    const double shared_ms = time_ms([&] {
+        std::vector<std::jthread> workers;
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] { run_stream(g, shared, depots, zipf_stream(queries, 100 + t)); });
+        }
+    });
+    const CacheStats s = shared.stats();
+    std::printf("%zu threads: %lu queries in %.1f ms, hit rate %.1f%%\n", threads, s.hits + s.misses, shared_ms,
+                100.0 * static_cast<double>(s.hits) / static_cast<double>(s.hits + s.misses));
+    return 0;
+}
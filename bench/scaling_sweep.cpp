@@ -0,0 +1,381 @@
+//
+// Asymptotic scaling of the engines against their bounds: Dijkstra O(m + n log n), BMSSP O(m log^(2/3) n).
+// For n from --min-n to --max-n (steps per decade) and each family, random directed graphs (stored as CSRGraph) and
+// square 4-neighbour grids (GridGraph, computed arcs), every engine runs from --sources sources and its time and
+// operation count (arcs scanned by Dijkstra, relaxations by BMSSP) are divided by its bound. A flat normalized curve
+// is the bound holding; a rise is constants that depend on n (cache misses once the arrays outgrow the caches) or work
+// the bound does not account for.
+// Per-query O(n) work, such as an assign(n_, ...) per call, hides in a full run whose cost is O(n) anyway, so each size
+// also times bounded_run queries reaching a fixed ball of --ball vertices with reused engines. Their time should not
+// depend on n at all.
+// After the sweep a least-squares fit of log time against log bound gives one exponent per engine (1 is the bound),
+// and every step whose local exponent exceeds 1 + --tolerance, every engine whose normalized time drifts more than
+// 3x and every ball query whose time grows faster than sqrt(n) is flagged. Results go to <out>.csv, <out>.gp plots
+// them with gnuplot (<out>.svg). Sizes whose graph and engine arrays would not fit into MemAvailable are skipped.
+// Usage: scaling_sweep [--min-n n] [--max-n n] [--steps k] [--degree d] [--families random,grid] [--sources s]
+//                      [--ball b] [--tolerance x] [--out prefix]
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BMSSP.h"
+#include "CSRGraph.h"
+#include "Dijkstra.h"
+#include "GridGraph.h"
+#include "SparseDistances.h"
+
+// Bytes per vertex the engines and the sweep hold on top of the graph: BMSSP's per-vertex arrays, its per-level
+// queue indices and stamps, Dijkstra's heap entries and the reference distances
+static constexpr double ENGINE_BYTES_PER_VERTEX = 256;
+static constexpr size_t BALL_QUERIES = 20;
+static constexpr double BALL_MAX_EXPONENT = 0.5;
+
+template <typename Fn>
+static double time_ms(Fn&& fn) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+enum class Bound {Dijkstra, BMSSP, Ball};
+
+static double bound(const Bound b, const double n, const double m, const double ball) {
+    switch (b) {
+        case Bound::Dijkstra: return m + n * std::log2(n);
+        case Bound::BMSSP: return m * std::pow(std::log2(n), 2.0 / 3.0);
+        case Bound::Ball: return ball;
+    }
+    return 1;
+}
+
+static const char* bound_name(const Bound b) {
+    switch (b) {
+        case Bound::Dijkstra: return "m + n log n";
+        case Bound::BMSSP: return "m log^(2/3) n";
+        case Bound::Ball: return "ball";
+    }
+    return "?";
+}
+
+struct Row {
+    std::string family;
+    uint64_t n;
+    uint64_t m;
+    std::string engine;
+    Bound bound_kind;
+    double ms;
+    double ops;
+    double bound;
+};
+
+// Random directed graph like random_graph (a Hamiltonian cycle plus uniform arcs, weights in [1, 100)) built straight
+// into CSR form, so that 10^8 vertices need the arcs and offsets only
+static CSRGraph random_csr(const uint64_t n, const double avg_degree, const uint64_t seed = 42) {
+    std::mt19937_64 gen(seed);
+    std::uniform_int_distribution<uint64_t> vertex_dist(0, n - 1);
+    std::uniform_real_distribution<double> weight_dist(1.0, 100.0);
+    const auto m = std::max(n, static_cast<uint64_t>(static_cast<double>(n) * avg_degree));
+    std::vector<uint64_t> tails(m);
+    std::vector<Edge> arcs;
+    arcs.reserve(m);
+    for (uint64_t i = 0; i < n; ++i) {
+        tails[i] = i;
+        arcs.emplace_back((i + 1) % n, weight_dist(gen));
+    }
+    for (uint64_t e = n; e < m; ++e) {
+        tails[e] = vertex_dist(gen);
+        arcs.emplace_back(vertex_dist(gen), weight_dist(gen));
+    }
+    // Counting sort by tail
+    PageVector<size_t> offsets(n + 1, 0);
+    for (const uint64_t t : tails) ++offsets[t + 1];
+    for (uint64_t v = 0; v < n; ++v) offsets[v + 1] += offsets[v];
+    PageVector<Edge> edges(m, Edge(0, 0));
+    std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+    for (uint64_t e = 0; e < m; ++e) edges[next[tails[e]]++] = arcs[e];
+    return {std::move(offsets), std::move(edges)};
+}
+
+static double mem_available_bytes() {
+    std::ifstream in("/proc/meminfo");
+    std::string key;
+    double kib;
+    std::string unit;
+    while (in >> key >> kib >> unit) {
+        if (key == "MemAvailable:") return kib * 1024;
+    }
+    return INFINITY;
+}
+
+template <SSSPGraph G>
+static uint64_t count_arcs(const G& g) {
+    uint64_t m = 0;
+    for (uint64_t v = 0; v < g.size(); ++v) m += std::ranges::distance(g.neighbors(v));
+    return m;
+}
+
+template <SSSPGraph G>
+static void sweep(const char* family, const G& g, const size_t num_sources, const size_t ball,
+                  std::vector<Row>& rows) {
+    const uint64_t n = g.size();
+    const uint64_t m = count_arcs(g);
+    std::vector<uint64_t> sources;
+    for (size_t i = 0; i < num_sources; ++i) sources.push_back(i * (n / num_sources) + n / (2 * num_sources));
+
+    // Fastest of the sources, the bounds are worst cases and the minimum is the least noisy estimate
+    double heap_ms = INFINITY, fib_ms = INFINITY, bmssp_ms = INFINITY, scanned = 0, relaxations = 0;
+    std::vector<double> reference;
+    for (const uint64_t src : sources) {
+        BasicDijkstra<G> dijkstra(g, src);
+        dijkstra.set_record_frames(false);
+        heap_ms = std::min(heap_ms, time_ms([&] { reference = dijkstra.std_heap_run(); }));
+        fib_ms = std::min(fib_ms, time_ms([&] { (void)dijkstra.fib_heap_run(); }));
+        // Every reached vertex is settled once and scans its arcs once
+        for (uint64_t v = 0; v < n; ++v) {
+            if (reference[v] < INFINITY) scanned += 1 + static_cast<double>(std::ranges::distance(g.neighbors(v)));
+        }
+
+        BasicBMSSP<G> bmssp(g, src);
+        bmssp.set_record_frames(false);
+        std::vector<double> dist;
+        bmssp_ms = std::min(bmssp_ms, time_ms([&] { dist = bmssp.run(); }));
+        relaxations += static_cast<double>(bmssp.counters().relaxations);
+        for (uint64_t v = 0; v < n; ++v) {
+            if (std::abs(dist[v] - reference[v]) > 1e-9 * std::max(1.0, std::abs(reference[v]))) {
+                std::fprintf(stderr, "%s n=%lu: BMSSP disagrees with Dijkstra at vertex %lu\n", family, n, v);
+                std::exit(1);
+            }
+        }
+    }
+    const auto s = static_cast<double>(sources.size());
+    const auto add = [&](const char* engine, const Bound b, const double ms, const double ops) {
+        rows.push_back({family, n, m, engine, b, ms, ops,
+                        bound(b, static_cast<double>(n), static_cast<double>(m), static_cast<double>(ball))});
+    };
+    add("std_heap_run", Bound::Dijkstra, heap_ms, scanned / s);
+    add("fib_heap_run", Bound::Dijkstra, fib_ms, scanned / s);
+    add("bmssp", Bound::BMSSP, bmssp_ms, relaxations / s);
+
+    // Balls of the same size around the last source, answered by engines that live across the queries
+    if (ball >= n) return;
+    std::vector<double> sorted = reference;
+    std::ranges::sort(sorted);
+    const double B = sorted[ball];
+    const uint64_t src = sources.back();
+    SparseDistances ws(n);
+    BasicDijkstra<G> dijkstra(g, src);
+    dijkstra.set_record_frames(false);
+    BasicBMSSP<G> bmssp(g, src);
+    bmssp.set_record_frames(false);
+    // The first bounded query allocates the per-level queue indices, keep it out of the timings
+    (void)bmssp.bounded_run(src, B);
+    size_t reached = 0;
+    double dijkstra_ball_ms = INFINITY, bmssp_ball_ms = INFINITY;
+    for (size_t q = 0; q < BALL_QUERIES; ++q) {
+        dijkstra_ball_ms = std::min(dijkstra_ball_ms, time_ms([&] { reached = dijkstra.bounded_run(B, ws).size(); }));
+        bmssp_ball_ms = std::min(bmssp_ball_ms, time_ms([&] { (void)bmssp.bounded_run(src, B); }));
+    }
+    add("dijkstra_ball", Bound::Ball, dijkstra_ball_ms, static_cast<double>(reached));
+    add("bmssp_ball", Bound::Ball, bmssp_ball_ms, static_cast<double>(reached));
+}
+
+// Least-squares slope of log y over log x
+static double fit_exponent(const std::vector<double>& x, const std::vector<double>& y) {
+    const auto k = static_cast<double>(x.size());
+    double sx = 0, sy = 0, sxx = 0, sxy = 0;
+    for (size_t i = 0; i < x.size(); ++i) {
+        const double lx = std::log(x[i]), ly = std::log(y[i]);
+        sx += lx;
+        sy += ly;
+        sxx += lx * lx;
+        sxy += lx * ly;
+    }
+    const double denominator = k * sxx - sx * sx;
+    return denominator == 0 ? NAN : (k * sxy - sx * sy) / denominator;
+}
+
+// Fits and flags per (family, engine), rows in order of n. Returns the number of flags.
+static size_t analyze(const std::vector<Row>& rows, const double tolerance) {
+    std::vector<std::pair<std::string, std::string>> series;
+    for (const Row& r : rows) {
+        if (std::ranges::find(series, std::pair{r.family, r.engine}) == series.end()) series.emplace_back(r.family, r.engine);
+    }
+    size_t flags = 0;
+    std::printf("\n%-8s %-14s %-14s %9s %12s %12s %8s\n", "family", "engine", "bound", "exponent", "ns/unit min",
+                "ns/unit max", "drift");
+    for (const auto& [family, engine] : series) {
+        std::vector<const Row*> points;
+        for (const Row& r : rows) {
+            if (r.family == family and r.engine == engine) points.push_back(&r);
+        }
+        const Bound b = points.front()->bound_kind;
+        // Runs under a millisecond are dominated by timer and allocation noise
+        std::vector<double> x, y, normalized;
+        for (const Row* p : points) {
+            if (b != Bound::Ball and p->ms < 1.0) continue;
+            x.push_back(b == Bound::Ball ? static_cast<double>(p->n) : p->bound);
+            y.push_back(p->ms);
+            normalized.push_back(p->ms * 1e6 / p->bound);
+        }
+        if (x.size() < 2) continue;
+        const double exponent = fit_exponent(x, y);
+        const auto [lo, hi] = std::ranges::minmax(normalized);
+        std::printf("%-8s %-14s %-14s %9.3f %12.3f %12.3f %7.2fx\n", family.c_str(), engine.c_str(), bound_name(b),
+                    exponent, lo, hi, hi / lo);
+
+        if (b == Bound::Ball) {
+            // A fixed ball costs the same at any n, unless the query touches something of size n: that part only
+            // shows once it outweighs the ball, then the local exponent over n heads for 1. BMSSP's k, t and levels
+            // grow with log n, a step in them can flag once as well.
+            for (size_t i = 1; i < x.size(); ++i) {
+                const double local = std::log(y[i] / y[i - 1]) / std::log(x[i] / x[i - 1]);
+                if (local > BALL_MAX_EXPONENT) {
+                    std::printf("  FLAG %s %s: a %s query grows like n^%.2f from %.3f ms at n=%.0f to %.3f ms at "
+                                "n=%.0f, per-call work that depends on n\n", family.c_str(), engine.c_str(),
+                                bound_name(b), local, y[i - 1], x[i - 1], y[i], x[i]);
+                    ++flags;
+                }
+            }
+            continue;
+        }
+        for (size_t i = 1; i < x.size(); ++i) {
+            const double local = std::log(y[i] / y[i - 1]) / std::log(x[i] / x[i - 1]);
+            if (local > 1 + tolerance) {
+                std::printf("  FLAG %s %s: local exponent %.2f against %s between bound %.3g and %.3g\n",
+                            family.c_str(), engine.c_str(), local, bound_name(b), x[i - 1], x[i]);
+                ++flags;
+            }
+        }
+        if (hi / lo > 3) {
+            std::printf("  FLAG %s %s: time per unit of %s drifts %.1fx over the sweep\n", family.c_str(),
+                        engine.c_str(), bound_name(b), hi / lo);
+            ++flags;
+        }
+    }
+    return flags;
+}
+
+static void write_csv(const std::vector<Row>& rows, const std::string& path) {
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) {
+        std::perror(path.c_str());
+        return;
+    }
+    std::fprintf(f, "family,n,m,engine,bound,ms,ops,bound_value,ns_per_unit,ops_per_unit\n");
+    for (const Row& r : rows) {
+        std::fprintf(f, "%s,%lu,%lu,%s,%s,%.6f,%.0f,%.6g,%.6f,%.6f\n", r.family.c_str(), r.n, r.m, r.engine.c_str(),
+                     bound_name(r.bound_kind), r.ms, r.ops, r.bound, r.ms * 1e6 / r.bound, r.ops / r.bound);
+    }
+    std::fclose(f);
+}
+
+// Time and operations per unit of the bound over n, one panel per family and measure
+static void write_gnuplot(const std::vector<Row>& rows, const std::string& prefix) {
+    std::vector<std::string> families, engines;
+    for (const Row& r : rows) {
+        if (std::ranges::find(families, r.family) == families.end()) families.push_back(r.family);
+        if (std::ranges::find(engines, r.engine) == engines.end()) engines.push_back(r.engine);
+    }
+    std::ofstream out(prefix + ".gp");
+    out << "set terminal svg size 1200," << 400 * families.size() << " dynamic\n"
+        << "set output '" << prefix << ".svg'\n"
+        << "set datafile separator ','\n"
+        << "set logscale xy\nset key outside right\nset grid\nset xlabel 'n'\n"
+        << "set multiplot layout " << families.size() << ",2\n";
+    const char* measures[][2] = {{"9", "ns per unit of the bound"}, {"10", "operations per unit of the bound"}};
+    for (const std::string& family : families) {
+        for (const auto& [column, label] : measures) {
+            out << "set title '" << family << ": " << label << "'\nplot ";
+            for (size_t e = 0; e < engines.size(); ++e) {
+                out << (e == 0 ? "" : ", \\\n     ") << "'" << prefix << ".csv' using 2:((strcol(1) eq '" << family
+                    << "' && strcol(4) eq '" << engines[e] << "') ? $" << column << " : 1/0) with linespoints title '"
+                    << engines[e] << "'";
+            }
+            out << "\n";
+        }
+    }
+    out << "unset multiplot\n";
+}
+
+static void usage() {
+    std::fprintf(stderr, "usage: scaling_sweep [--min-n n] [--max-n n] [--steps k] [--degree d] "
+                         "[--families random,grid] [--sources s] [--ball b] [--tolerance x] [--out prefix]\n");
+}
+
+int main(const int argc, char** argv) {
+    uint64_t min_n = 1'000, max_n = 10'000'000;
+    size_t steps = 2, num_sources = 3, ball = 1024;
+    double degree = 4.0, tolerance = 0.25;
+    std::string families = "random,grid", out = "scaling";
+    for (int i = 1; i < argc; ++i) {
+        const auto value = [&] {
+            if (i + 1 >= argc) {
+                usage();
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+        if (std::strcmp(argv[i], "--min-n") == 0) min_n = std::strtoull(value(), nullptr, 10);
+        else if (std::strcmp(argv[i], "--max-n") == 0) max_n = std::strtoull(value(), nullptr, 10);
+        else if (std::strcmp(argv[i], "--steps") == 0) steps = std::max(1ul, std::strtoul(value(), nullptr, 10));
+        else if (std::strcmp(argv[i], "--degree") == 0) degree = std::strtod(value(), nullptr);
+        else if (std::strcmp(argv[i], "--families") == 0) families = value();
+        else if (std::strcmp(argv[i], "--sources") == 0) num_sources = std::max(1ul, std::strtoul(value(), nullptr, 10));
+        else if (std::strcmp(argv[i], "--ball") == 0) ball = std::strtoul(value(), nullptr, 10);
+        else if (std::strcmp(argv[i], "--tolerance") == 0) tolerance = std::strtod(value(), nullptr);
+        else if (std::strcmp(argv[i], "--out") == 0) out = value();
+        else {
+            usage();
+            return 2;
+        }
+    }
+
+    std::vector<Row> rows;
+    std::printf("%-8s %10s %11s %-14s %12s %14s %12s\n", "family", "n", "m", "engine", "ms", "ops", "ns/unit");
+    for (const bool grid : {false, true}) {
+        const char* family = grid ? "grid" : "random";
+        if (families.find(family) == std::string::npos) continue;
+        for (size_t i = 0;; ++i) {
+            const double exact = static_cast<double>(min_n) * std::pow(10.0, static_cast<double>(i) / steps);
+            if (exact > static_cast<double>(max_n) * 1.0001) break;
+            const auto side = static_cast<uint32_t>(std::lround(std::sqrt(exact)));
+            const uint64_t n = grid ? static_cast<uint64_t>(side) * side : std::llround(exact);
+            // A grid stores no arcs, a CSR graph an Edge per arc and an offset per vertex
+            const double needed = static_cast<double>(n) * (ENGINE_BYTES_PER_VERTEX +
+                                                             (grid ? 0 : sizeof(size_t) + degree * sizeof(Edge)));
+            if (const double available = mem_available_bytes(); needed > available) {
+                std::printf("%-8s %10lu skipped: needs about %.1f GiB, %.1f GiB available\n", family, n,
+                            needed / (1 << 30), available / (1 << 30));
+                break;
+            }
+            const size_t first = rows.size();
+            if (grid) {
+                sweep(family, GridGraph(side, side), num_sources, ball, rows);
+            } else {
+                sweep(family, random_csr(n, degree), num_sources, ball, rows);
+            }
+            for (size_t r = first; r < rows.size(); ++r) {
+                std::printf("%-8s %10lu %11lu %-14s %12.3f %14.0f %12.3f\n", rows[r].family.c_str(), rows[r].n,
+                            rows[r].m, rows[r].engine.c_str(), rows[r].ms, rows[r].ops, rows[r].ms * 1e6 / rows[r].bound);
+            }
+            std::fflush(stdout);
+        }
+    }
+
+    const size_t flags = analyze(rows, tolerance);
+    write_csv(rows, out + ".csv");
+    write_gnuplot(rows, out);
+    std::printf("\n%zu flags; wrote %s.csv and %s.gp (gnuplot %s.gp draws %s.svg)\n", flags, out.c_str(), out.c_str(),
+                out.c_str(), out.c_str());
+    return 0;
+}
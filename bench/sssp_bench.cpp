@@ -0,0 +1,353 @@
+//
+// Headless benchmark runner. Loads a graph from CSV or builds one with a generator, picks sources with
+// get_start_vertices and times std_heap_run, fib_heap_run and BMSSP::run on each of them. Prints one JSON object on
+// stdout with mean/p50/p99 latency, throughput and peak RSS per engine. Every result is checked against an untimed
+// std_heap_run; the exit status is 1 if any engine disagrees.
+// A query is engine construction plus the run, frames off. Peak RSS is VmHWM, reset before each engine where the
+// kernel allows it (/proc/self/clear_refs), so it covers the graph, the reference distances and that engine.
+// Built with BMSSP_STATS, the output also holds the per-level statistics of one extra BMSSP run. Built with
+// PERF_COUNTERS, every engine lists the calls, time and hardware counters of each phase it went through; without
+// counter access ("perf_counters": false) only calls and time. --trace writes the recursion of one extra BMSSP run
+// from the first source as Chrome Trace Event JSON.
+// Built with MEMORY_ACCOUNTING, the graph's heap bytes are listed and every engine gets the current and peak bytes of
+// each subsystem during its queries. Its peak above what was allocated before it started, plus the graph, per vertex
+// gives the largest graph of this average degree that fits into --memory-budget GiB (default 64) with that engine.
+// Usage: sssp_bench [--csv file [--undirected] | --grid side | --random n degree | --power-law n degree]
+//                   [--sources k] [--repeat r] [--engines heap,fib,bmssp] [--trace file.json]
+//                   [--memory-budget GiB]
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "BMSSP.h"
+#include "Dijkstra.h"
+#include "GraphFactory.h"
+#include "MemoryAccounting.h"
+#include "PerfCounters.h"
+#include "TraceSink.h"
+
+template <typename Fn>
+static double time_ms(Fn&& fn) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+static double status_mib(const std::string& field) {
+    std::ifstream f("/proc/self/status");
+    std::string key;
+    while (f >> key) {
+        if (key == field + ":") {
+            double kb = 0;
+            f >> kb;
+            return kb / 1024.0;
+        }
+        f.ignore(4096, '\n');
+    }
+    return 0;
+}
+
+static void reset_peak_rss() {
+    std::ofstream f("/proc/self/clear_refs");
+    f << "5";
+}
+
+static std::string json_string(const std::string& s) {
+    std::string out = "\"";
+    for (const char c : s) {
+        if (c == '"' or c == '\\') out += '\\';
+        if (static_cast<unsigned char>(c) < 0x20) continue;
+        out += c;
+    }
+    return out + "\"";
+}
+
+// Nearest-rank percentile of sorted values
+static double percentile(const std::vector<double>& sorted, const double p) {
+    const auto rank = static_cast<size_t>(std::ceil(p / 100.0 * static_cast<double>(sorted.size())));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+static bool same_distance(const double a, const double b) {
+    return a == b or std::abs(a - b) <= 1e-9 * std::max(1.0, std::abs(b));
+}
+
+struct EngineRun {
+    const char* name;
+    std::function<std::vector<double>(const Graph&, const Vertex*)> run;
+};
+
+#if BMSSP_STATS
+// Per-level statistics of one more, untimed BMSSP run from source, top level first
+static void print_bmssp_stats(const Graph& g, const Vertex* source) {
+    BMSSP bmssp(g, source);
+    bmssp.set_record_frames(false);
+    (void)bmssp.run();
+    const auto& levels = bmssp.stats().levels;
+    std::printf("  \"bmssp_stats\": {\"k\": %zu, \"t\": %zu, \"levels\": [", bmssp.k(), bmssp.t());
+    for (size_t i = levels.size(); i-- > 0;) {
+        const BMSSPLevelStats& s = levels[i];
+        const DequeueCounters& d = s.dequeue;
+        std::printf("%s\n    {\"level\": %zu, \"calls\": %lu, \"find_pivots_calls\": %lu, \"pivot_rounds\": %lu, "
+                    "\"pivot_shortcuts\": %lu, \"W_total\": %lu, \"W_max\": %lu, \"P_total\": %lu, \"P_max\": %lu, "
+                    "\"base_cases\": %lu, \"base_case_settled\": %lu, \"pivot_relaxations\": %lu, "
+                    "\"completed_relaxations\": %lu,\n     \"dequeue\": {\"inserts\": %lu, \"batch_inserts\": %lu, "
+                    "\"batch_inserted\": %lu, \"erases\": %lu, \"splits\": %lu, \"batch_prepends\": %lu, "
+                    "\"prepended\": %lu, \"pulls\": %lu, \"pulled\": %lu, \"max_pull\": %lu},\n     "
+                    "\"find_pivots_ms\": %.3f, \"base_case_ms\": %.3f, \"pull_ms\": %.3f, \"relax_ms\": %.3f, "
+                    "\"insert_ms\": %.3f, \"prepend_ms\": %.3f, \"total_ms\": %.3f}",
+                    i + 1 == levels.size() ? "" : ",", i, s.calls, s.find_pivots_calls, s.pivot_rounds,
+                    s.pivot_shortcuts, s.W_total, s.W_max, s.P_total, s.P_max, s.base_cases, s.base_case_settled,
+                    s.pivot_relaxations, s.completed_relaxations, d.inserts, d.batch_inserts, d.batch_inserted,
+                    d.erases, d.splits, d.batch_prepends, d.prepended, d.pulls, d.pulled, d.max_pull,
+                    s.find_pivots_ms, s.base_case_ms, s.pull_ms, s.relax_ms, s.insert_ms, s.prepend_ms, s.total_ms);
+    }
+    std::printf("\n  ]},\n");
+}
+#endif
+
+#if PERF_COUNTERS
+// The phases the last engine went through, as the rest of its JSON object
+static void print_phases() {
+    std::printf(", \"phases\": [");
+    bool first = true;
+    for (size_t p = 0; p < perf::PHASES; ++p) {
+        const perf::Sample& s = perf::totals()[p];
+        if (s.calls == 0) continue;
+        std::printf("%s\n      {\"phase\": \"%s\", \"calls\": %lu, \"ms\": %.3f", first ? "" : ",",
+                    perf::phase_name(static_cast<perf::Phase>(p)), s.calls, s.ms);
+        if (perf::counters_available()) {
+            std::printf(", \"cycles\": %lu, \"instructions\": %lu, \"ipc\": %.3f, \"cache_misses\": %lu, "
+                        "\"branch_misses\": %lu",
+                        s.cycles, s.instructions,
+                        s.cycles == 0 ? 0.0 : static_cast<double>(s.instructions) / static_cast<double>(s.cycles),
+                        s.cache_misses, s.branch_misses);
+        }
+        std::printf("}");
+        first = false;
+    }
+    std::printf("]");
+}
+#endif
+
+#if MEMORY_ACCOUNTING
+// Heap bytes of the last engine's queries as the rest of its JSON object. base is the total allocated before they
+// started: the graph, the reference distances and the runner's own buffers.
+static void print_memory(const int64_t base, const int64_t graph_bytes, const size_t n, const double budget_gib) {
+    const memory::Usage total = memory::total();
+    const int64_t engine_peak = total.peak - base;
+    const double per_vertex = static_cast<double>(graph_bytes + engine_peak) / static_cast<double>(n);
+    std::printf(", \"memory\": {\"peak_bytes\": %ld, \"engine_peak_bytes\": %ld, \"bytes_per_vertex\": %.1f, "
+                "\"max_vertices_in_budget\": %.0f, \"subsystems\": {", total.peak, engine_peak, per_vertex,
+                budget_gib * 1024 * 1024 * 1024 / per_vertex);
+    const auto usage = memory::usage();
+    for (size_t s = 0; s < memory::SUBSYSTEMS; ++s) {
+        std::printf("%s\n      \"%s\": {\"current\": %ld, \"peak\": %ld, \"allocations\": %lu}", s == 0 ? "" : ",",
+                    memory::subsystem_name(static_cast<memory::Subsystem>(s)), usage[s].current, usage[s].peak,
+                    usage[s].allocations);
+    }
+    std::printf("}}");
+}
+#endif
+
+static void usage() {
+    std::fprintf(stderr, "usage: sssp_bench [--csv file [--undirected] | --grid side | --random n degree | "
+                         "--power-law n degree] [--sources k] [--repeat r] [--engines heap,fib,bmssp] "
+                         "[--trace file.json] [--memory-budget GiB]\n");
+}
+
+int main(const int argc, char** argv) {
+    std::string graph_kind = "random", csv_file, engines = "heap,fib,bmssp", trace_file;
+    uint64_t n = 100'000, side = 300;
+    double degree = 4.0;
+    size_t sources = 8, repeat = 1;
+    [[maybe_unused]] double memory_budget_gib = 64;
+    GraphType csv_type = GraphType::DIRECTED;
+    for (int i = 1; i < argc; ++i) {
+        const auto arg = [&](const int ahead) {
+            if (i + ahead >= argc) {
+                usage();
+                std::exit(2);
+            }
+            return argv[i + ahead];
+        };
+        if (std::strcmp(argv[i], "--csv") == 0) {
+            graph_kind = "csv";
+            csv_file = arg(1);
+            i += 1;
+        } else if (std::strcmp(argv[i], "--undirected") == 0) {
+            csv_type = GraphType::UNDIRECTED;
+        } else if (std::strcmp(argv[i], "--grid") == 0) {
+            graph_kind = "grid";
+            side = std::strtoull(arg(1), nullptr, 10);
+            i += 1;
+        } else if (std::strcmp(argv[i], "--random") == 0 or std::strcmp(argv[i], "--power-law") == 0) {
+            graph_kind = argv[i] + 2;
+            n = std::strtoull(arg(1), nullptr, 10);
+            degree = std::strtod(arg(2), nullptr);
+            i += 2;
+        } else if (std::strcmp(argv[i], "--sources") == 0) {
+            sources = std::strtoul(arg(1), nullptr, 10);
+            i += 1;
+        } else if (std::strcmp(argv[i], "--repeat") == 0) {
+            repeat = std::max<size_t>(1, std::strtoul(arg(1), nullptr, 10));
+            i += 1;
+        } else if (std::strcmp(argv[i], "--trace") == 0) {
+            trace_file = arg(1);
+            i += 1;
+        } else if (std::strcmp(argv[i], "--memory-budget") == 0) {
+            memory_budget_gib = std::strtod(arg(1), nullptr);
+            i += 1;
+        } else if (std::strcmp(argv[i], "--engines") == 0) {
+            engines = arg(1);
+            i += 1;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    Graph g(GraphType::DIRECTED);
+    std::string graph_name;
+    const double load_ms = time_ms([&] {
+        if (graph_kind == "csv") {
+            g = graph_from_csv(csv_file.c_str(), csv_type);
+            graph_name = csv_file;
+        } else if (graph_kind == "grid") {
+            g = Graph(static_cast<int>(side), static_cast<int>(side));
+            graph_name = "grid " + std::to_string(side) + "x" + std::to_string(side);
+        } else if (graph_kind == "random") {
+            g = random_graph(n, degree);
+            graph_name = "random n=" + std::to_string(n) + " deg=" + std::to_string(degree);
+        } else {
+            g = power_law_graph(n, degree);
+            graph_name = "power-law n=" + std::to_string(n) + " deg=" + std::to_string(degree);
+        }
+    });
+    if (g.empty()) {
+        std::fprintf(stderr, "sssp_bench: empty graph\n");
+        return 2;
+    }
+
+    size_t with_edges = 0;
+    for (const auto& v : g.get_vertices()) {
+        with_edges += v.outgoing_edges_.empty() ? 0 : 1;
+    }
+    const auto starts = get_start_vertices(g, static_cast<int>(std::min(sources, with_edges)));
+    if (starts.empty()) {
+        std::fprintf(stderr, "sssp_bench: no sources\n");
+        return 2;
+    }
+
+    std::vector<std::vector<double>> reference;
+    for (const Vertex* s : starts) {
+        Dijkstra dijkstra(g, s);
+        dijkstra.set_record_frames(false);
+        reference.push_back(dijkstra.std_heap_run());
+    }
+
+    std::vector<EngineRun> runs;
+    for (const auto& [key, run] : std::vector<std::pair<std::string, EngineRun>>{
+             {"heap", {"std_heap_run", [](const Graph& graph, const Vertex* s) {
+                  Dijkstra dijkstra(graph, s);
+                  dijkstra.set_record_frames(false);
+                  return dijkstra.std_heap_run();
+              }}},
+             {"fib", {"fib_heap_run", [](const Graph& graph, const Vertex* s) {
+                  const Dijkstra dijkstra(graph, s);
+                  return dijkstra.fib_heap_run();
+              }}},
+             {"bmssp", {"bmssp", [](const Graph& graph, const Vertex* s) {
+                  BMSSP bmssp(graph, s);
+                  bmssp.set_record_frames(false);
+                  return bmssp.run();
+              }}}}) {
+        if (("," + engines + ",").find("," + key + ",") != std::string::npos) {
+            runs.push_back(run);
+        }
+    }
+
+    std::printf("{\n  \"graph\": {\"name\": %s, \"n\": %zu, \"edges\": %zu, \"directed\": %s, \"load_ms\": %.3f},\n",
+                json_string(graph_name).c_str(), g.size(), g.edges_size(),
+                g.type() == GraphType::DIRECTED ? "true" : "false", load_ms);
+#if PERF_COUNTERS
+    std::printf("  \"perf_counters\": %s,\n", perf::counters_available() ? "true" : "false");
+#endif
+#if MEMORY_ACCOUNTING
+    const int64_t graph_bytes = memory::usage()[static_cast<size_t>(memory::Subsystem::Graph)].current;
+    std::printf("  \"memory\": {\"graph_bytes\": %ld, \"graph_bytes_per_vertex\": %.1f, \"budget_gib\": %.1f},\n",
+                graph_bytes, static_cast<double>(graph_bytes) / static_cast<double>(g.size()), memory_budget_gib);
+#endif
+    std::printf("  \"sources\": %zu,\n  \"repeat\": %zu,\n  \"engines\": [", starts.size(), repeat);
+
+    bool all_agree = true;
+    for (size_t e = 0; e < runs.size(); ++e) {
+        reset_peak_rss();
+#if PERF_COUNTERS
+        perf::reset();
+#endif
+#if MEMORY_ACCOUNTING
+        memory::reset_peaks();
+        const int64_t memory_base = memory::total().current;
+#endif
+        std::vector<double> latencies;
+        size_t mismatches = 0;
+        double total_ms = 0;
+        for (size_t r = 0; r < repeat; ++r) {
+            for (size_t i = 0; i < starts.size(); ++i) {
+                std::vector<double> dist;
+                const double ms = time_ms([&] { dist = runs[e].run(g, starts[i]); });
+                latencies.push_back(ms);
+                total_ms += ms;
+                if (r > 0) continue;
+                for (size_t v = 0; v < dist.size(); ++v) {
+                    mismatches += same_distance(dist[v], reference[i][v]) ? 0 : 1;
+                }
+            }
+        }
+        const double peak = status_mib("VmHWM");
+        std::ranges::sort(latencies);
+        all_agree = all_agree and mismatches == 0;
+        std::printf("%s\n    {\"engine\": \"%s\", \"queries\": %zu, \"mean_ms\": %.3f, \"p50_ms\": %.3f, "
+                    "\"p99_ms\": %.3f, \"throughput_qps\": %.3f, \"peak_rss_mib\": %.1f, \"mismatches\": %zu, "
+                    "\"agree\": %s",
+                    e == 0 ? "" : ",", runs[e].name, latencies.size(),
+                    total_ms / static_cast<double>(latencies.size()), percentile(latencies, 50),
+                    percentile(latencies, 99), 1000.0 * static_cast<double>(latencies.size()) / total_ms, peak,
+                    mismatches, mismatches == 0 ? "true" : "false");
+#if PERF_COUNTERS
+        print_phases();
+#endif
+#if MEMORY_ACCOUNTING
+        print_memory(memory_base, graph_bytes, g.size(), memory_budget_gib);
+#endif
+        std::printf("}");
+    }
+    std::printf("\n  ],\n");
+#if BMSSP_STATS
+    if (("," + engines + ",").find(",bmssp,") != std::string::npos) {
+        print_bmssp_stats(g, starts.front());
+    }
+#endif
+    if (!trace_file.empty()) {
+        TraceSink trace;
+        BMSSP bmssp(g, starts.front());
+        bmssp.set_record_frames(false);
+        bmssp.set_trace(&trace);
+        (void)bmssp.run();
+        std::printf("  \"trace\": {\"file\": %s, \"events\": %zu, \"written\": %s},\n",
+                    json_string(trace_file).c_str(), trace.size(), trace.write(trace_file) ? "true" : "false");
+    }
+    std::printf("  \"agree\": %s\n}\n", all_agree ? "true" : "false");
+    return all_agree ? 0 : 1;
+}
@@ -0,0 +1,53 @@
+//
+// Local calibration run for SSSPDispatcher. Times heap Dijkstra, Fibonacci-heap Dijkstra and BMSSP on a suite of grids
+// and random graphs up to max_n vertices (plus any CSV graphs given) and writes the calibration table.
+// Usage: sssp_calibrate [max_n] [sources] [file.csv ...]
+//
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "GraphFactory.h"
+#include "SSSPDispatcher.h"
+
+static void add_point(dispatch::CalibrationTable& table, const char* name, Graph& g, const size_t sources) {
+    const dispatch::CalibrationPoint p = dispatch::CalibrationTable::measure(g, sources);
+    std::printf("%-24s %10zu %11zu %8.2f %8.2f %8.2f %12.3f %12.3f %12.3f  -> %s\n", name, p.stats.n, p.stats.arcs,
+                p.stats.mean_degree, p.stats.degree_cv, p.stats.weight_cv, p.ms[0], p.ms[1], p.ms[2],
+                dispatch::engine_name(p.fastest()));
+    table.points.push_back(p);
+}
+
+int main(const int argc, char** argv) {
+    const size_t max_n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1'000'000;
+    const size_t sources = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 3;
+
+    using dispatch::Engine, dispatch::engine_name;
+    dispatch::CalibrationTable table;
+    std::printf("%-24s %10s %11s %8s %8s %8s %12s %12s %12s\n", "graph", "n", "arcs", "deg", "deg_cv", "w_cv",
+                engine_name(Engine::HeapDijkstra), engine_name(Engine::FibDijkstra), engine_name(Engine::BMSSP));
+
+    for (size_t side = 32; side * side <= max_n; side *= 2) {
+        Graph g(static_cast<int>(side), static_cast<int>(side));
+        char name[64];
+        std::snprintf(name, sizeof(name), "grid %zux%zu", side, side);
+        add_point(table, name, g, sources);
+    }
+    for (size_t n = 1000; n <= max_n; n *= 10) {
+        for (const double degree : {2.0, 4.0, 16.0}) {
+            Graph g = random_graph(n, degree);
+            char name[64];
+            std::snprintf(name, sizeof(name), "random n=%zu deg=%.0f", n, degree);
+            add_point(table, name, g, sources);
+        }
+    }
+    for (int i = 3; i < argc; ++i) {
+        Graph g = graph_from_csv(argv[i], GraphType::DIRECTED);
+        if (g.empty()) continue;
+        add_point(table, argv[i], g, sources);
+    }
+
+    table.save();
+    std::printf("%zu points written to %s\n", table.points.size(), dispatch::CalibrationTable::path().c_str());
+    return 0;
+}
@@ -0,0 +1,559 @@
+//
+// Differential fuzzer for the SSSP engines. Generates graphs across size classes (tiny, small, medium), topologies
+// (random with and without a spanning cycle, power law, non-square grids), degrees and weight classes (uniform, unit,
+// small integers, six decades), runs every engine on them and compares each distance with std_heap_run within the
+// 1e-9 relative tolerance the perturbation dirt allows. Weights carry dirt < 1e-4 like Graph::add_edge, --ties drops
+// it to test exact ties, which BMSSP does not handle (it relies on the dirt for distinct path lengths).
+// Every case runs in a child process, so a crash or a hang (--timeout seconds) is reported as a failure of the engine
+// it happened in instead of taking the fuzzer down. A failing case is shrunk by removing arcs and unused vertices
+// while it keeps failing, and written as from,to,weight CSV that --replay runs again (weights are used exactly as
+// written, unlike graph_from_csv, which perturbs them).
+// Engine times are summed per size class. --save-baseline stores them, --baseline compares against a stored file and
+// fails if an engine got slower than --slowdown times its baseline (sums under 20 ms are too noisy and skipped).
+// Exit status: 0 all good, 1 wrong distances, crash or hang, 2 usage, 3 slowdown.
+// Usage: sssp_fuzz [--cases n] [--seed s] [--max-n n] [--timeout sec] [--ties] [--baseline file]
+//                  [--save-baseline file] [--slowdown x] [--replay file.csv --source s]
+//
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "BMSSP.h"
+#include "CSRGraph.h"
+#include "Dijkstra.h"
+#include "GraphFactory.h"
+#include "MultiSourceSSSP.h"
+
+static constexpr double INF = std::numeric_limits<double>::infinity();
+static constexpr double MIN_COMPARE_MS = 20.0;
+// Candidate runs a minimization may take, a hang costs the whole timeout per candidate
+static constexpr size_t MAX_MINIMIZE_RUNS = 2000;
+
+enum Engine {
+    HeapDijkstra,
+    FibDijkstra,
+    BMSSPGraph,
+    BMSSPThreads,
+    BMSSPCSR,
+    CSRDijkstra,
+    BMSSPBounded,
+    BMSSPReused,
+    MultiSource,
+    ENGINES
+};
+
+static const char* ENGINE_NAMES[ENGINES] = {"std_heap_run", "fib_heap_run", "bmssp", "bmssp_threads", "bmssp_csr",
+                                            "dijkstra_csr", "bmssp_bounded", "bmssp_reused", "multi_source"};
+
+static const char* SIZE_CLASSES[] = {"tiny", "small", "medium"};
+
+struct Arc {
+    uint64_t from, to;
+    double weight;
+};
+
+// A graph as a plain arc list, built as a directed Graph with the weights as they are
+struct Case {
+    uint64_t n = 0;
+    uint64_t source = 0;
+    std::vector<Arc> arcs;
+    std::string description;
+    int size_class = 0;
+
+    [[nodiscard]] Graph build() const {
+        Graph g(GraphType::DIRECTED);
+        for (uint64_t v = 0; v < n; ++v) g.add_vertex(v);
+        for (const auto& [from, to, w] : arcs) g.add_edge(from, to, w, false);
+        return g;
+    }
+};
+
+enum class Status {Ok, Mismatch, Exception, Crash, Timeout};
+
+static const char* status_name(const Status s) {
+    switch (s) {
+        case Status::Ok: return "ok";
+        case Status::Mismatch: return "wrong distance";
+        case Status::Exception: return "exception";
+        case Status::Crash: return "crash";
+        case Status::Timeout: return "timeout";
+    }
+    return "?";
+}
+
+// What a child reports back through its pipe
+struct Outcome {
+    Status status = Status::Ok;
+    int engine = -1;
+    uint64_t vertex = 0;
+    double expected = 0, got = 0;
+    double ms[ENGINES] = {};
+};
+
+static bool same_distance(const double a, const double b) {
+    return a == b or std::abs(a - b) <= 1e-9 * std::max(1.0, std::abs(b));
+}
+
+static double time_ms(const std::function<void()>& fn) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Child side: announces each engine on fd before running it, then writes marker -1 and the Outcome. With only set,
+// just the reference and that engine run.
+static void run_engines(const Case& c, const int fd, const int only) {
+    const Graph g = c.build();
+    const CSRGraph csr(g);
+    Outcome out;
+    std::vector<double> reference;
+    double bound = INF, near_bound = INF;
+
+    const std::function<std::vector<double>()> runs[ENGINES] = {
+        [&] {
+            Dijkstra dijkstra(g, c.source);
+            dijkstra.set_record_frames(false);
+            return dijkstra.std_heap_run();
+        },
+        [&] { return Dijkstra(g, c.source).fib_heap_run(); },
+        [&] {
+            BMSSP bmssp(g, c.source);
+            bmssp.set_record_frames(false);
+            return bmssp.run();
+        },
+        [&] {
+            BMSSP bmssp(g, c.source);
+            bmssp.set_record_frames(false);
+            bmssp.set_threads(4);
+            return bmssp.run();
+        },
+        [&] {
+            BasicBMSSP<CSRGraph> bmssp(csr, c.source);
+            bmssp.set_record_frames(false);
+            return bmssp.run();
+        },
+        [&] {
+            BasicDijkstra<CSRGraph> dijkstra(csr, c.source);
+            dijkstra.set_record_frames(false);
+            return dijkstra.std_heap_run();
+        },
+        [&] {
+            BMSSP bmssp(g, c.source);
+            bmssp.set_record_frames(false);
+            std::vector<double> dist(c.n, INF);
+            for (const auto& [v, d] : bmssp.bounded_run(c.source, bound)) dist[v] = d;
+            return dist;
+        },
+        [&] {
+            // A bounded query on an engine that has done a full run, which must leave nothing behind. A ball of little
+            // more than the source, as the full run settled the source at the top level.
+            BMSSP bmssp(g, c.source);
+            bmssp.set_record_frames(false);
+            (void)bmssp.run();
+            std::vector<double> dist(c.n, INF);
+            for (const auto& [v, d] : bmssp.bounded_run(c.source, near_bound)) dist[v] = d;
+            return dist;
+        },
+        [&] {
+            // The case's source in lane 0, the other lanes keep the rounds honest
+            std::vector<uint64_t> sources = {c.source};
+            for (uint64_t i = 1; i < 8 and i < c.n; ++i) sources.push_back((c.source + i * 7919) % c.n);
+            MultiSourceSSSP<Graph, 8> engine(g);
+            engine.run(sources);
+            return engine.distances(0);
+        },
+    };
+
+    for (int e = 0; e < ENGINES; ++e) {
+        if (only >= 0 and e != HeapDijkstra and e != only) continue;
+        const int32_t marker = e;
+        (void)!write(fd, &marker, sizeof(marker));
+        std::vector<double> dist;
+        try {
+            out.ms[e] = time_ms([&] { dist = runs[e](); });
+        } catch (const std::exception&) {
+            out.status = Status::Exception;
+            out.engine = e;
+            break;
+        }
+        if (e == HeapDijkstra) {
+            reference = dist;
+            // Half of the reachable vertices fall below the bound of the bounded run
+            std::vector<double> finite;
+            for (const double d : reference) {
+                if (d < INF) finite.push_back(d);
+            }
+            std::ranges::sort(finite);
+            bound = finite.empty() ? 1.0 : finite[finite.size() / 2];
+            // Just past the source: the smallest positive distance
+            const auto positive = std::ranges::upper_bound(finite, 0.0);
+            near_bound = positive == finite.end() ? 1.0 : *positive;
+            continue;
+        }
+        for (uint64_t v = 0; v < c.n; ++v) {
+            const double limit = e == BMSSPBounded ? bound : e == BMSSPReused ? near_bound : INF;
+            const double expected = reference[v] >= limit ? INF : reference[v];
+            const double got = v < dist.size() ? dist[v] : -1.0;
+            if (!same_distance(got, expected)) {
+                out.status = Status::Mismatch;
+                out.engine = e;
+                out.vertex = v;
+                out.expected = expected;
+                out.got = got;
+                break;
+            }
+        }
+        if (out.status != Status::Ok) break;
+    }
+    const int32_t done = -1;
+    (void)!write(fd, &done, sizeof(done));
+    (void)!write(fd, &out, sizeof(out));
+}
+
+// Runs the case in a child process and turns crashes and hangs into outcomes as well
+static Outcome run_case(const Case& c, const int timeout_s, const int only = -1) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        std::perror("pipe");
+        std::exit(2);
+    }
+    std::fflush(stdout);
+    const pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        run_engines(c, fds[1], only);
+        _exit(0);
+    }
+    close(fds[1]);
+
+    Outcome out;
+    int current = -1;
+    bool finished = false;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(timeout_s);
+    while (!finished) {
+        const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline -
+                                                                              std::chrono::steady_clock::now());
+        pollfd p{fds[0], POLLIN, 0};
+        if (left.count() <= 0 or poll(&p, 1, static_cast<int>(left.count())) == 0) {
+            kill(pid, SIGKILL);
+            out.status = Status::Timeout;
+            out.engine = current;
+            break;
+        }
+        int32_t marker;
+        if (read(fds[0], &marker, sizeof(marker)) != sizeof(marker)) {
+            out.status = Status::Crash;
+            out.engine = current;
+            break;
+        }
+        if (marker >= 0) {
+            current = marker;
+            continue;
+        }
+        finished = read(fds[0], &out, sizeof(out)) == sizeof(out);
+        if (!finished) {
+            out.status = Status::Crash;
+            out.engine = current;
+            break;
+        }
+    }
+    close(fds[0]);
+    waitpid(pid, nullptr, 0);
+    return out;
+}
+
+static Case generate(const uint64_t seed, const int index, const uint64_t max_n, const bool ties) {
+    std::mt19937_64 gen(seed * 1'000'003 + static_cast<uint64_t>(index));
+    const auto uniform = [&](const double lo, const double hi) { return std::uniform_real_distribution(lo, hi)(gen); };
+    const auto pick = [&](const uint64_t lo, const uint64_t hi) {
+        return std::uniform_int_distribution<uint64_t>(lo, std::max(lo, hi))(gen);
+    };
+
+    Case c;
+    c.size_class = index % 3;
+    const uint64_t n = c.size_class == 0 ? pick(2, 64) : c.size_class == 1 ? pick(64, 2048)
+                                                                           : pick(2048, std::max<uint64_t>(max_n, 2048));
+    const double degree = std::array{1.5, 4.0, 12.0}[pick(0, 2)];
+    char description[128];
+
+    switch (pick(0, 3)) {
+        case 0:
+        case 1: {
+            // Without the cycle parts of the graph stay unreachable
+            const bool cycle = pick(0, 1) == 1;
+            const bool symmetric = pick(0, 3) == 0;
+            c.n = n;
+            if (cycle) {
+                for (uint64_t v = 0; v < n; ++v) c.arcs.push_back({v, (v + 1) % n, 1.0});
+            }
+            const auto m = static_cast<uint64_t>(static_cast<double>(n) * degree);
+            while (c.arcs.size() < m) {
+                const uint64_t from = pick(0, n - 1), to = pick(0, n - 1);
+                c.arcs.push_back({from, to, 1.0});
+                if (symmetric) c.arcs.push_back({to, from, 1.0});
+            }
+            std::snprintf(description, sizeof(description), "random%s%s deg=%.1f", cycle ? " cycle" : "",
+                          symmetric ? " symmetric" : "", degree);
+            break;
+        }
+        case 2: {
+            const Graph g = power_law_graph(n, degree, 2.1, gen());
+            c.n = g.size();
+            for (const auto& v : g.get_vertices()) {
+                for (const auto& e : v.outgoing_edges_) c.arcs.push_back({v.id_, e.to_id_, 1.0});
+            }
+            std::snprintf(description, sizeof(description), "power-law deg=%.1f", degree);
+            break;
+        }
+        default: {
+            // Deliberately not square
+            const auto width = static_cast<int>(pick(1, static_cast<uint64_t>(std::sqrt(static_cast<double>(n))) * 2));
+            const int height = std::max(1, static_cast<int>(n / static_cast<uint64_t>(width)));
+            const Graph g(width, height);
+            c.n = g.size();
+            for (const auto& v : g.get_vertices()) {
+                for (const auto& e : v.outgoing_edges_) c.arcs.push_back({v.id_, e.to_id_, 1.0});
+            }
+            std::snprintf(description, sizeof(description), "grid %dx%d", width, height);
+            break;
+        }
+    }
+
+    const int weights = static_cast<int>(pick(0, 3));
+    static const char* WEIGHT_CLASSES[] = {"uniform", "unit", "int1-4", "wide"};
+    for (auto& arc : c.arcs) {
+        switch (weights) {
+            case 0: arc.weight = uniform(1.0, 100.0); break;
+            case 1: arc.weight = 1.0; break;
+            case 2: arc.weight = static_cast<double>(pick(1, 4)); break;
+            default: arc.weight = std::pow(10.0, uniform(-3.0, 3.0)); break;
+        }
+        // The same dirt as Graph::add_edge
+        if (!ties) arc.weight += static_cast<double>(pick(0, 9999)) / 1E8;
+    }
+
+    std::vector<uint64_t> with_arcs;
+    for (const auto& arc : c.arcs) with_arcs.push_back(arc.from);
+    c.source = with_arcs.empty() ? 0 : with_arcs[pick(0, with_arcs.size() - 1)];
+    c.description = std::string(SIZE_CLASSES[c.size_class]) + " " + description + " " + WEIGHT_CLASSES[weights] +
+                    " n=" + std::to_string(c.n) + " m=" + std::to_string(c.arcs.size());
+    return c;
+}
+
+// Drops vertices no arc touches (the source stays) and renumbers the rest densely
+static Case compact(const Case& c) {
+    std::vector<uint64_t> id(c.n, UINT64_MAX);
+    id[c.source] = 0;
+    Case out = c;
+    out.n = 1;
+    for (const auto& arc : c.arcs) {
+        for (const uint64_t v : {arc.from, arc.to}) {
+            if (id[v] == UINT64_MAX) id[v] = out.n++;
+        }
+    }
+    out.source = 0;
+    for (auto& arc : out.arcs) {
+        arc.from = id[arc.from];
+        arc.to = id[arc.to];
+    }
+    return out;
+}
+
+// Removes ever smaller chunks of arcs as long as the engine keeps failing the same way, then drops the vertices left
+// unused
+static Case minimize(Case c, const Outcome& failure, const int timeout_s) {
+    size_t runs = 0;
+    const auto fails = [&](const Case& candidate) {
+        ++runs;
+        const Outcome out = run_case(candidate, timeout_s, failure.engine);
+        return out.status == failure.status and out.engine == failure.engine;
+    };
+    size_t chunk = std::max<size_t>(1, c.arcs.size() / 2);
+    while (true) {
+        bool removed = false;
+        for (size_t begin = 0; begin < c.arcs.size() and runs < MAX_MINIMIZE_RUNS;) {
+            Case candidate = c;
+            const size_t end = std::min(begin + chunk, candidate.arcs.size());
+            candidate.arcs.erase(candidate.arcs.begin() + static_cast<long>(begin),
+                                 candidate.arcs.begin() + static_cast<long>(end));
+            if (fails(candidate)) {
+                c = std::move(candidate);
+                removed = true;
+            } else {
+                begin += chunk;
+            }
+        }
+        if (!removed) {
+            if (chunk == 1 or runs >= MAX_MINIMIZE_RUNS) break;
+            chunk /= 2;
+        }
+    }
+    const Case compacted = compact(c);
+    return fails(compacted) ? compacted : c;
+}
+
+static void report(const Outcome& out) {
+    if (out.status == Status::Ok) {
+        std::printf("  ok\n");
+        return;
+    }
+    std::printf("  %s in %s", status_name(out.status), out.engine >= 0 ? ENGINE_NAMES[out.engine] : "setup");
+    if (out.status == Status::Mismatch) {
+        std::printf(": vertex %lu expected %.17g got %.17g", out.vertex, out.expected, out.got);
+    }
+    std::printf("\n");
+}
+
+static bool save_csv(const Case& c, const std::string& path) {
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) return false;
+    for (const auto& [from, to, w] : c.arcs) std::fprintf(f, "%lu,%lu,%.17g\n", from, to, w);
+    return std::fclose(f) == 0;
+}
+
+static Case load_csv(const std::string& path, const uint64_t source) {
+    Case c;
+    c.source = source;
+    c.n = source + 1;
+    std::FILE* f = std::fopen(path.c_str(), "r");
+    if (!f) return c;
+    Arc arc{};
+    while (std::fscanf(f, "%lu,%lu,%lf", &arc.from, &arc.to, &arc.weight) == 3) {
+        c.arcs.push_back(arc);
+        c.n = std::max({c.n, arc.from + 1, arc.to + 1});
+    }
+    std::fclose(f);
+    c.description = path;
+    return c;
+}
+
+using Timings = std::map<std::pair<std::string, std::string>, double>;
+
+static void usage() {
+    std::fprintf(stderr, "usage: sssp_fuzz [--cases n] [--seed s] [--max-n n] [--timeout sec] [--ties] "
+                         "[--baseline file] [--save-baseline file] [--slowdown x] [--replay file.csv --source s]\n");
+}
+
+int main(const int argc, char** argv) {
+    size_t cases = 60;
+    uint64_t seed = 1, max_n = 20'000, source = 0;
+    int timeout_s = 20;
+    bool ties = false;
+    double slowdown = 1.5;
+    std::string baseline, save_baseline, replay;
+    for (int i = 1; i < argc; ++i) {
+        const auto value = [&] {
+            if (i + 1 >= argc) {
+                usage();
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+        if (std::strcmp(argv[i], "--cases") == 0) cases = std::strtoul(value(), nullptr, 10);
+        else if (std::strcmp(argv[i], "--seed") == 0) seed = std::strtoull(value(), nullptr, 10);
+        else if (std::strcmp(argv[i], "--max-n") == 0) max_n = std::strtoull(value(), nullptr, 10);
+        else if (std::strcmp(argv[i], "--timeout") == 0) timeout_s = std::atoi(value());
+        else if (std::strcmp(argv[i], "--ties") == 0) ties = true;
+        else if (std::strcmp(argv[i], "--baseline") == 0) baseline = value();
+        else if (std::strcmp(argv[i], "--save-baseline") == 0) save_baseline = value();
+        else if (std::strcmp(argv[i], "--slowdown") == 0) slowdown = std::strtod(value(), nullptr);
+        else if (std::strcmp(argv[i], "--replay") == 0) replay = value();
+        else if (std::strcmp(argv[i], "--source") == 0) source = std::strtoull(value(), nullptr, 10);
+        else {
+            usage();
+            return 2;
+        }
+    }
+
+    if (!replay.empty()) {
+        const Case c = load_csv(replay, source);
+        std::printf("%s: n=%lu m=%zu source %lu\n", replay.c_str(), c.n, c.arcs.size(), c.source);
+        const Outcome out = run_case(c, timeout_s);
+        report(out);
+        return out.status == Status::Ok ? 0 : 1;
+    }
+
+    // Same seed, count and size give the same cases, which is what makes timings comparable to a baseline
+    const std::string config = "seed=" + std::to_string(seed) + " cases=" + std::to_string(cases) +
+                               " max-n=" + std::to_string(max_n) + (ties ? " ties" : "");
+    Timings timings;
+    size_t failures = 0;
+    for (size_t i = 0; i < cases; ++i) {
+        // Generation uses the graph constructors and factories, which can be what is broken
+        Case c;
+        try {
+            c = generate(seed, static_cast<int>(i), max_n, ties);
+        } catch (const std::exception& e) {
+            ++failures;
+            std::printf("case %zu: generating the graph threw: %s\n", i, e.what());
+            continue;
+        }
+        const Outcome out = run_case(c, timeout_s);
+        if (out.status == Status::Ok) {
+            for (int e = 0; e < ENGINES; ++e) timings[{ENGINE_NAMES[e], SIZE_CLASSES[c.size_class]}] += out.ms[e];
+            continue;
+        }
+        ++failures;
+        std::printf("case %zu (%s), source %lu\n", i, c.description.c_str(), c.source);
+        report(out);
+        const Case small = minimize(c, out, timeout_s);
+        const std::string path = "sssp_fuzz_case" + std::to_string(i) + ".csv";
+        std::printf("  minimized to n=%lu m=%zu, source %lu%s; rerun with --replay %s --source %lu\n", small.n,
+                    small.arcs.size(), small.source, save_csv(small, path) ? "" : " (could not write the CSV)",
+                    path.c_str(), small.source);
+        report(run_case(small, timeout_s, out.engine));
+    }
+
+    std::printf("%zu cases (%s), %zu failed\n\n%-14s", cases, config.c_str(), failures, "ms");
+    for (const char* size : SIZE_CLASSES) std::printf(" %10s", size);
+    std::printf("\n");
+    for (const char* engine : ENGINE_NAMES) {
+        std::printf("%-14s", engine);
+        for (const char* size : SIZE_CLASSES) std::printf(" %10.1f", timings[{engine, size}]);
+        std::printf("\n");
+    }
+
+    int status = failures == 0 ? 0 : 1;
+    if (!baseline.empty()) {
+        std::ifstream in(baseline);
+        std::string line;
+        if (!std::getline(in, line) or line != "# sssp_fuzz " + config) {
+            std::fprintf(stderr, "%s was not recorded with %s\n", baseline.c_str(), config.c_str());
+            return 2;
+        }
+        std::string engine, size;
+        double ms;
+        while (in >> engine >> size >> ms) {
+            const double now = timings[{engine, size}];
+            if (ms < MIN_COMPARE_MS or now <= slowdown * ms) continue;
+            std::printf("slowdown: %s on %s graphs %.1f ms, baseline %.1f ms (%.2fx > %.2fx)\n", engine.c_str(),
+                        size.c_str(), now, ms, now / ms, slowdown);
+            if (status == 0) status = 3;
+        }
+    }
+    if (!save_baseline.empty()) {
+        std::ofstream out(save_baseline);
+        out << "# sssp_fuzz " << config << "\n";
+        for (const auto& [key, ms] : timings) out << key.first << " " << key.second << " " << ms << "\n";
+        std::printf("baseline written to %s\n", save_baseline.c_str());
+    }
+    return status;
+}
@@ -0,0 +1,255 @@
+//
+// The hot data structures on their own, for catching regressions without running whole SSSP queries.
+// 1. Heap operations recorded from fib_heap_run, replayed on FibHeap and on std::priority_queue<Pair> with lazy
+//    deletion (what std_heap_run does). Every extract_min has to return the recorded key.
+// 2. DequeueBlocks operations recorded from BMSSP::run, replayed on fresh queues. Every pull has to return as many
+//    keys and the same bound as in the recording.
+// 3. Synthetic DequeueBlocks workloads for M in {16, 256, 4096} and uniform, ascending and heavily tied values: insert
+//    every key, erase a quarter of them, then pull until empty while prepending every 8th pulled key once.
+// Times are the best of `reps` runs, in ns per operation (per element for batches and pulls).
+// Usage: structure_bench [n] [side] [keys] [reps]
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "BMSSP.h"
+#include "Dijkstra.h"
+#include "GraphFactory.h"
+
+template <typename Fn>
+static double time_ms(Fn&& fn) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+template <typename Fn>
+static double best_ms(const size_t reps, Fn&& fn) {
+    double best = std::numeric_limits<double>::infinity();
+    for (size_t r = 0; r < reps; ++r) {
+        best = std::min(best, time_ms(fn));
+    }
+    return best;
+}
+
+static double ns_per(const double ms, const size_t ops) {
+    return ops == 0 ? 0.0 : ms * 1e6 / static_cast<double>(ops);
+}
+
+// Mismatching extract_min keys
+static size_t replay_fib_heap(const HeapRecording& rec) {
+    FibHeap<HeapKey> heap;
+    std::vector<Node<HeapKey>*> nodes(rec.n, nullptr);
+    size_t mismatches = 0;
+    for (const auto& [kind, v, key] : rec.ops) {
+        switch (kind) {
+            case HeapOpKind::Insert:
+                nodes[v] = heap.insert({key, v});
+                break;
+            case HeapOpKind::DecreaseKey:
+                heap.decrease_key(nodes[v], {key, v});
+                break;
+            case HeapOpKind::ExtractMin:
+                mismatches += heap.extract_min().dist == key ? 0 : 1;
+                break;
+        }
+    }
+    return mismatches;
+}
+
+static size_t replay_std_heap(const HeapRecording& rec) {
+    std::priority_queue<Pair, std::vector<Pair>, std::greater<>> pq;
+    std::vector<double> current(rec.n);
+    std::vector<uint8_t> extracted(rec.n, 0);
+    size_t mismatches = 0;
+    for (const auto& [kind, v, key] : rec.ops) {
+        if (kind != HeapOpKind::ExtractMin) {
+            current[v] = key;
+            pq.emplace(v, key);
+            continue;
+        }
+        // Entries superseded by a lower key stay behind and are skipped here
+        while (extracted[pq.top().key_] or pq.top().value_ != current[pq.top().key_]) pq.pop();
+        mismatches += pq.top().value_ == key ? 0 : 1;
+        extracted[pq.top().key_] = 1;
+        pq.pop();
+    }
+    return mismatches;
+}
+
+// Pulls that differ from the recording in size or bound
+static size_t replay_dequeue(const DequeueRecording& rec) {
+    std::vector<std::unique_ptr<DequeueBlocks>> queues(rec.queues);
+    std::vector<DequeueIndex*> index_of(rec.queues, nullptr);
+    // Queues leave their index clean, so as in BMSSP a handful of indices serves all of them
+    std::vector<std::unique_ptr<DequeueIndex>> indices;
+    std::vector<DequeueIndex*> free_indices;
+    std::vector<Pair> batch;
+    size_t mismatches = 0;
+    for (const DequeueOp& op : rec.ops) {
+        switch (op.kind) {
+            case DequeueOpKind::Create:
+                if (free_indices.empty()) {
+                    indices.push_back(std::make_unique<DequeueIndex>(rec.n));
+                    free_indices.push_back(indices.back().get());
+                }
+                index_of[op.queue] = free_indices.back();
+                free_indices.pop_back();
+                queues[op.queue] = std::make_unique<DequeueBlocks>(*index_of[op.queue], op.key, op.value);
+                break;
+            case DequeueOpKind::Destroy:
+                queues[op.queue].reset();
+                free_indices.push_back(index_of[op.queue]);
+                break;
+            case DequeueOpKind::Insert:
+                queues[op.queue]->insert(op.key, op.value);
+                break;
+            case DequeueOpKind::Erase:
+                queues[op.queue]->erase(op.key);
+                break;
+            case DequeueOpKind::BatchInsert:
+                batch.assign(rec.pairs.begin() + op.first, rec.pairs.begin() + op.first + op.count);
+                queues[op.queue]->batch_insert(batch);
+                break;
+            case DequeueOpKind::BatchPrepend:
+                batch.assign(rec.pairs.begin() + op.first, rec.pairs.begin() + op.first + op.count);
+                queues[op.queue]->batch_prepend(batch, op.value);
+                break;
+            case DequeueOpKind::Pull: {
+                const auto [S, x] = queues[op.queue]->pull();
+                mismatches += S.size() == op.count and x == op.value ? 0 : 1;
+                break;
+            }
+        }
+    }
+    return mismatches;
+}
+
+static void recorded(const char* name, const Graph& g, const size_t reps) {
+    const uint64_t src = get_start_vertices(g, 1).front()->id_;
+
+    HeapRecording heap_rec;
+    Dijkstra dijkstra(g, src);
+    dijkstra.set_heap_recording(&heap_rec);
+    (void)dijkstra.fib_heap_run();
+    size_t counts[3] = {};
+    for (const auto& op : heap_rec.ops) ++counts[static_cast<size_t>(op.kind)];
+
+    DequeueRecording dequeue_rec;
+    BMSSP bmssp(g, src);
+    bmssp.set_record_frames(false);
+    bmssp.set_dequeue_recording(&dequeue_rec);
+    (void)bmssp.run();
+    // Elements count single inserts and erases once, batches and pulls by their size
+    size_t dq_counts[7] = {}, elements = 0;
+    for (const auto& op : dequeue_rec.ops) {
+        ++dq_counts[static_cast<size_t>(op.kind)];
+        if (op.kind == DequeueOpKind::Insert or op.kind == DequeueOpKind::Erase) {
+            elements += 1;
+        } else if (op.kind != DequeueOpKind::Create and op.kind != DequeueOpKind::Destroy) {
+            elements += op.count;
+        }
+    }
+
+    std::printf("%s: n=%zu, source %lu\n", name, g.size(), src);
+    std::printf("  heap ops: %zu inserts, %zu decrease_keys, %zu extract_mins\n", counts[0], counts[1], counts[2]);
+    size_t fib_bad = 0, std_bad = 0;
+    const double fib_ms = best_ms(reps, [&] { fib_bad = replay_fib_heap(heap_rec); });
+    const double std_ms = best_ms(reps, [&] { std_bad = replay_std_heap(heap_rec); });
+    std::printf("  %-28s %10.2f ms %8.1f ns/op %6s\n", "FibHeap replay", fib_ms, ns_per(fib_ms, heap_rec.ops.size()),
+                fib_bad == 0 ? "ok" : "FAIL");
+    std::printf("  %-28s %10.2f ms %8.1f ns/op %6s\n", "priority_queue<Pair> replay", std_ms,
+                ns_per(std_ms, heap_rec.ops.size()), std_bad == 0 ? "ok" : "FAIL");
+
+    std::printf("  dequeue ops: %u queues, %zu inserts, %zu batch_inserts, %zu erases, %zu batch_prepends, %zu pulls, "
+                "%zu pairs\n", dequeue_rec.queues, dq_counts[2], dq_counts[3], dq_counts[4], dq_counts[5],
+                dq_counts[6], dequeue_rec.pairs.size());
+    size_t dq_bad = 0;
+    const double dq_ms = best_ms(reps, [&] { dq_bad = replay_dequeue(dequeue_rec); });
+    std::printf("  %-28s %10.2f ms %8.1f ns/elem %4s\n\n", "DequeueBlocks replay", dq_ms, ns_per(dq_ms, elements),
+                dq_bad == 0 ? "ok" : "FAIL");
+}
+
+enum class KeyDist {Uniform, Ascending, Ties};
+
+static void synthetic(const size_t keys, const size_t reps) {
+    std::printf("%-6s %-10s %10s %10s %12s %10s\n", "M", "values", "insert", "erase", "prepend", "pull");
+    for (const size_t M : {16ul, 256ul, 4096ul}) {
+        for (const KeyDist dist : {KeyDist::Uniform, KeyDist::Ascending, KeyDist::Ties}) {
+            std::mt19937_64 gen(7);
+            std::vector<double> values(keys);
+            for (size_t i = 0; i < keys; ++i) {
+                switch (dist) {
+                    case KeyDist::Uniform:
+                        values[i] = std::uniform_real_distribution(0.0, 1e6)(gen);
+                        break;
+                    // Inserted roughly in order, like the distances a Dijkstra front produces
+                    case KeyDist::Ascending:
+                        values[i] = static_cast<double>(i) + std::uniform_real_distribution(0.0, 64.0)(gen);
+                        break;
+                    case KeyDist::Ties:
+                        values[i] = static_cast<double>(gen() % 64);
+                        break;
+                }
+            }
+
+            double insert_ms = INFINITY, erase_ms = INFINITY, prepend_ms = INFINITY, pull_ms = INFINITY;
+            size_t prepended = 0, pulled = 0;
+            DequeueIndex index(keys);
+            std::vector<uint8_t> requeued(keys);
+            std::vector<Pair> batch;
+            for (size_t r = 0; r < reps; ++r) {
+                DequeueBlocks D(index, M, INFINITY);
+                insert_ms = std::min(insert_ms, time_ms([&] {
+                    for (size_t i = 0; i < keys; ++i) D.insert(i, values[i]);
+                }));
+                erase_ms = std::min(erase_ms, time_ms([&] {
+                    for (size_t i = 0; i < keys; i += 4) D.erase(i);
+                }));
+                std::ranges::fill(requeued, 0);
+                double prepend = 0, pull = 0;
+                prepended = pulled = 0;
+                while (!D.empty()) {
+                    std::pair<std::vector<Pair>, double> result;
+                    pull += time_ms([&] { result = D.pull(); });
+                    pulled += result.first.size();
+                    batch.clear();
+                    for (size_t i = 0; i < result.first.size(); i += 8) {
+                        if (requeued[result.first[i].key_]) continue;
+                        requeued[result.first[i].key_] = 1;
+                        batch.push_back(result.first[i]);
+                    }
+                    prepended += batch.size();
+                    prepend += time_ms([&] { D.batch_prepend(batch, result.second); });
+                }
+                prepend_ms = std::min(prepend_ms, prepend);
+                pull_ms = std::min(pull_ms, pull);
+            }
+            const char* name = dist == KeyDist::Uniform ? "uniform" : dist == KeyDist::Ascending ? "ascending" : "ties";
+            std::printf("%-6zu %-10s %8.1f ns %8.1f ns %10.1f ns %8.1f ns\n", M, name, ns_per(insert_ms, keys),
+                        ns_per(erase_ms, (keys + 3) / 4), ns_per(prepend_ms, prepended), ns_per(pull_ms, pulled));
+        }
+    }
+}
+
+int main(const int argc, char** argv) {
+    const uint64_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200'000;
+    const int side = argc > 2 ? std::atoi(argv[2]) : 400;
+    const size_t keys = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 1 << 18;
+    const size_t reps = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 5;
+
+    recorded("random", random_graph(n, 4.0), reps);
+    recorded("grid", Graph(side, side), reps);
+    synthetic(keys, reps);
+    return 0;
+}
@@ -1,234 +1,558 @@
 #include "BMSSP.h"
 
+#include <algorithm>
 #include <cmath>
 #include <functional>
 #include <queue>
 #include <ranges>
 
+#include "CSRGraph.h"
+#include "GridGraph.h"
+#include "MemoryAccounting.h"
+#include "MutableGraph.h"
+#include "Parallel.h"
+#include "PerfCounters.h"
+#include "RelaxKernels.h"
+
 static constexpr double INF = std::numeric_limits<double>::infinity();
+static constexpr size_t NO_OWNER = std::numeric_limits<size_t>::max();
+// Layers smaller than this are relaxed on the calling thread, spawning workers costs more than it saves
+static constexpr size_t PARALLEL_MIN_LAYER = 2048;
 
 
-BMSSP::BMSSP(Graph &graph, const Vertex* src) : graph_(graph), source_(src) {
-    n_ = graph.get_vertices().size();
-    k_ = static_cast<size_t>(std::pow(std::log2(n_), 1.0/3.0));
-    t_ = static_cast<size_t>(std::pow(std::log2(n_), 2.0/3.0));
+template <SSSPGraph G>
+BasicBMSSP<G>::BasicBMSSP(const G& graph, const uint64_t src) : graph_(graph), source_(src) {
+    MEMORY_SCOPE(Engine);
+    n_ = graph.size();
+    // At least 1, a single vertex has log2(n) = 0 and would divide the level count by zero
+    k_ = std::max<size_t>(1, static_cast<size_t>(std::pow(std::log2(n_), 1.0/3.0)));
+    t_ = std::max<size_t>(1, static_cast<size_t>(std::pow(std::log2(n_), 2.0/3.0)));
 
-    pivot_root_cache_.reserve(n_);
-    pivot_tree_sz_cache_.reserve(n_);
+    pivot_root_cache_.assign(n_, 0);
+    pivot_tree_sz_cache_.assign(n_, 0);
+    pivot_visited_.assign(n_, 0);
+    claim_owner_.assign(n_, NO_OWNER);
     dist_cache_.assign(n_, INF);
     last_complete_level_.resize(n_, -1);
     finalized_.resize(n_, false);
 }
 
-BMSSP::BMSSP(Graph &graph, const Vertex* src, const size_t k, const size_t t) : graph_(graph), source_(src), n_(graph.size()), k_(k), t_(t) {
-    pivot_root_cache_.reserve(n_);
-    pivot_tree_sz_cache_.reserve(n_);
+template <SSSPGraph G>
+BasicBMSSP<G>::BasicBMSSP(const G& graph, const uint64_t src, const size_t k, const size_t t) : graph_(graph), source_(src), n_(graph.size()), k_(k), t_(t) {
+    MEMORY_SCOPE(Engine);
+    pivot_root_cache_.assign(n_, 0);
+    pivot_tree_sz_cache_.assign(n_, 0);
+    pivot_visited_.assign(n_, 0);
+    claim_owner_.assign(n_, NO_OWNER);
     dist_cache_.assign(n_, INF);
     last_complete_level_.resize(n_, -1);
     finalized_.resize(n_, false);
 }
 
-std::pair<VertexSet, VertexSet> BMSSP::find_pivots(const VertexSet& S, const double B) const {
+/*
+Relax every out-edge of layer in two phases separated by a join:
+1. every edge (u, v) with cand = d(u) + w(u, v) < B and cand ≤ d̂[v] lowers d̂[v] by an atomic min and is buffered,
+2. of the buffered relaxations only those with cand = d̂[v] survive, and the smallest layer position among them
+   claims v (see claim).
+relaxed[tid] ends up holding the surviving relaxations of the tid-th chunk of the layer, in layer order.
+*/
+template <SSSPGraph G>
+void BasicBMSSP<G>::relax_layer(const VertexSet& layer, const double B, const size_t threads,
+                        std::vector<std::vector<Relaxation>>& relaxed) const {
+    // parallel_for may use fewer chunks than threads, clear every buffer so none keeps entries of an earlier layer
+    for (auto& buf : relaxed) {
+        buf.clear();
+    }
+    parallel::parallel_for(layer.size(), threads, [&](const size_t begin, const size_t end, const size_t tid) {
+        auto& buf = relaxed[tid];
+        for (size_t j = begin; j < end; ++j) {
+            const auto& [u, d_u] = layer[j];
+            const uint64_t root = pivot_root_cache_[u];
+            // The layer is known in advance, so the first targets of the next vertex are on their way meanwhile
+            if constexpr (relax_kernels::StoredArcs<G>) {
+                if (j + 1 < end) {
+                    relax_kernels::prefetch_targets(graph_.neighbors(layer[j + 1].key_), dist_cache_.data());
+                }
+            }
+            if (threads == 1) {
+                relax_kernels::relax<true>(graph_.neighbors(u), d_u, B, dist_cache_.data(),
+                                           [&](const uint64_t v, const double cand) {
+                    dist_cache_[v] = cand;
+                    buf.push_back(Relaxation{v, cand, root, j});
+                });
+                continue;
+            }
+            relax_kernels::for_each_prefetched(graph_.neighbors(u),
+                                               [&](const uint64_t v) { relax_kernels::prefetch(&dist_cache_[v]); },
+                                               [&](const uint64_t v, const double w_uv) {
+                const double cand = d_u + w_uv;
+                if (cand < B and cand <= parallel::atomic_load(dist_cache_[v])) {
+                    parallel::atomic_min(dist_cache_[v], cand);
+                    buf.push_back(Relaxation{v, cand, root, j});
+                }
+            });
+        }
+    });
+
+    for (const auto& buf : relaxed) {
+        counters_.relaxations += buf.size();
+    }
+
+    parallel::parallel_for(layer.size(), threads, [&](size_t, size_t, const size_t tid) {
+        auto& buf = relaxed[tid];
+        size_t kept = 0;
+        for (const auto& r : buf) {
+            if (r.cand == parallel::atomic_load(dist_cache_[r.v])) {
+                parallel::atomic_min(claim_owner_[r.v], r.src);
+                buf[kept++] = r;
+            }
+        }
+        buf.resize(kept);
+    });
+}
+
+// True for exactly one surviving relaxation per target, the first one of the claiming layer position. Resetting the
+// owner drops parallel edges of the claimant and leaves claim_owner_ clean for the next layer.
+template <SSSPGraph G>
+bool BasicBMSSP<G>::claim(const Relaxation& r) const {
+    if (parallel::atomic_load(claim_owner_[r.v]) != r.src) return false;
+    parallel::atomic_store(claim_owner_[r.v], NO_OWNER);
+    return true;
+}
 
+/*
+One Bellman-Ford round of find_pivots over the layer W_prev. After relax_layer each claimant passes its pivot root on
+to v and appends v to its thread's share of Wi, and to its share of fresh if v is not in W yet. A vertex of W whose
+distance improved has to be relaxed again in the next round, so Wi is not restricted to new vertices. Distances, roots
+and both lists (their order included) depend on the layer alone, never on the thread count or interleaving.
+*/
+template <SSSPGraph G>
+void BasicBMSSP<G>::relax_round(const VertexSet& W_prev, const double B, std::vector<std::vector<Relaxation>>& relaxed,
+                        std::vector<VertexSet>& found, std::vector<VertexSet>& fresh) const {
+    const size_t threads = W_prev.size() >= PARALLEL_MIN_LAYER ? threads_ : 1;
+    ++counters_.pivot_rounds;
+    relax_layer(W_prev, B, threads, relaxed);
+
+    for (size_t tid = 0; tid < found.size(); ++tid) {
+        found[tid].clear();
+        fresh[tid].clear();
+    }
+    parallel::parallel_for(W_prev.size(), threads, [&](size_t, size_t, const size_t tid) {
+        for (const auto& r : relaxed[tid]) {
+            if (!claim(r)) continue;
+            pivot_root_cache_[r.v] = r.root;
+            found[tid].emplace_back(r.v, r.cand);
+            if (!pivot_visited_[r.v]) {
+                pivot_visited_[r.v] = true;
+                fresh[tid].emplace_back(r.v, r.cand);
+            }
+        }
+    });
+}
+
+/*
+Relax the out-edges of the vertices Ui just completed by a recursive call and route each improved neighbour once, with
+its final distance: into inserts[tid] if it falls into [Bi, B), into prepends[tid] if it falls into [B'i, Bi).
+Concatenated by tid both lists come out in the same order for every thread count.
+*/
+template <SSSPGraph G>
+void BasicBMSSP<G>::relax_completed(const VertexSet& Ui, const double Bi_prime, const double Bi, const double B,
+                            std::vector<std::vector<Relaxation>>& relaxed, std::vector<VertexSet>& inserts,
+                            std::vector<VertexSet>& prepends) const {
+    PERF_SCOPE(Relax);
+    const size_t threads = Ui.size() >= PARALLEL_MIN_LAYER ? threads_ : 1;
+    // Candidates ≥ B are left to the caller, which relaxes the same vertices again as part of its own Ui. Bounding
+    // here keeps every written distance below the bound of the top call, which bounded_run relies on.
+    relax_layer(Ui, B, threads, relaxed);
+
+    for (size_t tid = 0; tid < inserts.size(); ++tid) {
+        inserts[tid].clear();
+        prepends[tid].clear();
+    }
+    parallel::parallel_for(Ui.size(), threads, [&](size_t, size_t, const size_t tid) {
+        for (const auto& r : relaxed[tid]) {
+            if (!claim(r)) continue;
+            if (r.cand >= Bi and r.cand < B) {
+                inserts[tid].emplace_back(r.v, r.cand);
+            } else if (r.cand >= Bi_prime and r.cand < Bi) {
+                prepends[tid].emplace_back(r.v, r.cand);
+            }
+        }
+    });
+}
+
+template <SSSPGraph G>
+std::pair<VertexSet, VertexSet> BasicBMSSP<G>::find_pivots(const VertexSet& S, const double B) const {
+    PERF_SCOPE(FindPivots);
     VertexSet W = S;
     VertexSet W_prev = S;
 
-    pivot_root_cache_.assign(n_, 0);
-    pivot_tree_sz_cache_.assign(n_, 0);
-
-    std::vector<bool> pivot_visited_(n_, false);
     for (const auto& [u, du] : S) {
-        pivot_root_cache_[u->id_] = u->id_;
-        pivot_visited_[u->id_] = true;
+        pivot_root_cache_[u] = u;
+        pivot_visited_[u] = true;
     }
 
+    std::vector<std::vector<Relaxation>> relaxed(threads_);
+    std::vector<VertexSet> found(threads_), fresh(threads_);
+    // Only entries of W are touched, clear them instead of the whole arrays
+    auto reset = [&] {
+        for (const auto& [vtx, _] : W) {
+            pivot_visited_[vtx] = false;
+            pivot_tree_sz_cache_[vtx] = 0;
+        }
+    };
+
     for (size_t i = 1; i <= k_; ++i) {
+        relax_round(W_prev, B, relaxed, found, fresh);
+
         VertexSet Wi;
-        for (const auto& [u, d_u] : W_prev) {
-            for (const auto& [v_id, w_uv] : u->outgoing_edges_) {
-                const Vertex *v = graph_.get_vertex(v_id);
-                const double cand = d_u + w_uv;
-                if (cand < B and cand <= dist_cache_[v->id_]) {
-                    dist_cache_[v->id_] = cand;
-                    if (dist_cache_[v->id_] < B) {
-                        pivot_root_cache_[v->id_] = pivot_root_cache_[u->id_];
-                        if (!pivot_visited_[v->id_]) {
-                            pivot_visited_[v->id_] = true;
-                            Wi.emplace_back(v, cand);
-                        }
-                    }
-                }
-            }
+        for (size_t tid = 0; tid < found.size(); ++tid) {
+            Wi.insert(Wi.end(), found[tid].begin(), found[tid].end());
+            W.insert(W.end(), fresh[tid].begin(), fresh[tid].end());
         }
         if (Wi.empty()) break;
-
-        W.insert(W.end(), Wi.begin(), Wi.end());
         W_prev = std::move(Wi);
 
         if (W.size() > k_ * S.size()) {
+            reset();
             return {S, std::move(W)};
         }
     }
 
     for (const auto& [vtx, _] : W) {
-        pivot_tree_sz_cache_[pivot_root_cache_[vtx->id_]]++;
+        pivot_tree_sz_cache_[pivot_root_cache_[vtx]]++;
     }
 
     VertexSet P;
     P.reserve(W.size() / k_);
     for (const auto& [u, du] : S) {
-        if (pivot_tree_sz_cache_[u->id_] >= k_)
+        if (pivot_tree_sz_cache_[u] >= k_)
             P.emplace_back(u, du);
     }
 
+    reset();
     return {std::move(P), std::move(W)};
 }
 
-std::pair<double, VertexSet> BMSSP::base_case(const Pair& S, const double B) {
-    const auto& [v_ptr, v_dist] = S;
-
+template <SSSPGraph G>
+std::pair<double, VertexSet> BasicBMSSP<G>::base_case(const VertexSet& S, const double B) {
+    PERF_SCOPE(BaseCase);
     std::priority_queue<Pair, VertexSet, std::function<bool(const Pair&, const Pair&)>> H(
         [](const Pair& a, const Pair& b) {
             return b < a;
         });
-    H.emplace(v_ptr, v_dist);
+    // Every vertex of S seeds the heap, S need not be a singleton
+    for (const auto& [v, d_v] : S) {
+        H.emplace(v, d_v);
+    }
 
     VertexSet U;
-    U.reserve(k_ + 1);
-
-    while (!H.empty() and U.size() < k_ + 1) {
+    U.reserve(k_ + S.size());
+    // Level 0 stamps are only used here, every base case marks the vertices of its U with a number of its own
+    const uint64_t call = ++calls_;
+    PageVector<uint64_t>& U_stamp = U_stamps(0);
+
+    // Drop heap entries that are stale or, through equal distances, queued a second time
+    auto skip_settled = [&] {
+        while (!H.empty() and (H.top().value_ > dist_cache_[H.top().key_] or U_stamp[H.top().key_] == call)) {
+            H.pop();
+        }
+    };
+    auto settle_top = [&] {
         const auto [u, d_u] = H.top();
         H.pop();
-
-        if (d_u > dist_cache_[u->id_]) continue;
-        finalized_[u->id_] = true;
+        finalized_[u] = true;
+        U_stamp[u] = call;
         U.emplace_back(u, d_u);
-        for (const auto& [v_id, w_uv] : u->outgoing_edges_) {
-            const Vertex *v = graph_.get_vertex(v_id);
-            const double cand = d_u + w_uv;
-            if (cand < B and cand <= dist_cache_[v->id_]) {
-                dist_cache_[v->id_] = cand;
-                H.emplace(v, cand);
-            }
-        }
+        relax_kernels::relax<true>(graph_.neighbors(u), d_u, B, dist_cache_.data(),
+                                   [&](const uint64_t v, const double cand) {
+            ++counters_.relaxations;
+            dist_cache_[v] = cand;
+            H.emplace(v, cand);
+        });
+    };
+
+    skip_settled();
+    while (!H.empty() and U.size() < k_ + 1) {
+        settle_top();
+        skip_settled();
     }
 
     if (U.size() <= k_) {
-        push_state(BMSSP_Event::BaseCase, 0, B, dist_cache_, finalized_, U,{}, S.key_->id_);
+        push_state(BMSSP_Event::BaseCase, 0, B, dist_cache_, finalized_, U,{}, S[0].key_);
         return {B, U};
     }
 
-    double B_new = dist_cache_[U.back().key_->id_];
-    U.pop_back();
-    push_state(BMSSP_Event::BaseCase, 0,B, dist_cache_, finalized_, U,{}, S.key_->id_);
+    // U = {v ∈ U0 : d(v) < B'}, which drops every vertex tied with the last one
+    double B_new = dist_cache_[U.back().key_];
+    if (dist_cache_[U.front().key_] < B_new) {
+        std::erase_if(U, [&](const Pair& p) { return dist_cache_[p.key_] >= B_new; });
+    } else {
+        // All of U0 ties with B'. An empty U would hand the same subproblem back forever, so settle the whole tie and
+        // bound U by the next larger distance instead.
+        while (!H.empty() and H.top().value_ == B_new) {
+            settle_top();
+            skip_settled();
+        }
+        B_new = H.empty() ? B : H.top().value_;
+    }
+    push_state(BMSSP_Event::BaseCase, 0,B, dist_cache_, finalized_, U,{}, S[0].key_);
 
     return {B_new, std::move(U)};
 }
 
-std::pair<double, VertexSet> BMSSP::bmssp(const int l, const double B, const VertexSet& S) {
+template <SSSPGraph G>
+std::pair<double, VertexSet> BasicBMSSP<G>::bmssp(const int l, const double B, const VertexSet& S) {
     push_state(BMSSP_Event::RecurseEnter, l, B, dist_cache_, finalized_, S, {}, -1);
+#if BMSSP_STATS
+    BMSSPLevelStats& ls = stats_.levels[l];
+    ++ls.calls;
+    BMSSPStats::Stopwatch total, phase;
+    uint64_t relaxed_before = counters_.relaxations;
+#endif
     if (l == 0) {
-        return base_case(S[0], B);
+        ++counters_.base_cases;
+        auto result = base_case(S, B);
+#if BMSSP_STATS
+        ++ls.base_cases;
+        ls.base_case_settled += result.second.size();
+        ls.completed_relaxations += counters_.relaxations - relaxed_before;
+        ls.base_case_ms += phase.lap();
+        ls.total_ms += total.lap();
+#endif
+        return result;
     }
 
+    const uint64_t call = ++calls_;
+    PageVector<uint64_t>& U_stamp = U_stamps(l);
+    BMSSP_STATS_ONLY(const uint64_t rounds = counters_.pivot_rounds;)
     auto [P, W] = find_pivots(S, B);
+#if BMSSP_STATS
+    ls.find_pivots_ms += phase.lap();
+    ++ls.find_pivots_calls;
+    ls.pivot_rounds += counters_.pivot_rounds - rounds;
+    ls.pivot_relaxations += counters_.relaxations - relaxed_before;
+    ls.pivot_shortcuts += W.size() > k_ * S.size() ? 1 : 0;
+    ls.W_total += W.size();
+    ls.W_max = std::max<uint64_t>(ls.W_max, W.size());
+    ls.P_total += P.size();
+    ls.P_max = std::max<uint64_t>(ls.P_max, P.size());
+#endif
     push_state(BMSSP_Event::Pivots, l, B, dist_cache_, finalized_, S,P,-1);
 
     const auto M = static_cast<size_t>(std::pow(2, (l - 1) * t_));
-    DequeueBlocks D(n_, M, B);
+    DequeueBlocks D(dequeue_index(l), M, B);
+    if (dequeue_recording_) D.set_recording(dequeue_recording_);
     double B_prime = B;
+    BMSSP_STATS_ONLY(phase.restart();)
     for (const auto& [vtx, dist_v] : P) {
         D.insert(vtx, dist_v);
         B_prime = std::min(B_prime, dist_v);
     }
+    BMSSP_STATS_ONLY(ls.insert_ms += phase.lap();)
     push_state(BMSSP_Event::Frontier, l, B_prime,dist_cache_, finalized_,P,P,-1);
 
     VertexSet U;
     const auto cap = static_cast<size_t>(std::pow(2, l * t_));
     U.reserve(W.size() + cap);
 
+    // Per-thread buffers of relax_completed, reused by every iteration
+    std::vector<std::vector<Relaxation>> relaxed(threads_);
+    std::vector<VertexSet> inserts(threads_), prepends(threads_);
+
     while (U.size() < cap and not D.empty()) {
+        BMSSP_STATS_ONLY(phase.restart();)
         auto [Si, Bi] = D.pull();
+        BMSSP_STATS_ONLY(ls.pull_ms += phase.lap();)
+        ++counters_.pulls;
         if (Si.empty()) break;
         push_state(BMSSP_Event::Pull, l, Bi, dist_cache_, finalized_,Si,{},-1);
 
-        auto [Bi_prime, Ui] = bmssp(l - 1, Bi, Si);
+        // Keys tied with Bi are the smallest in D and complete already (see DequeueBlocks::pull), a sub-call bounded
+        // by Bi would find nothing below it to settle
+        auto [Bi_prime, Ui] = Si.front().value_ == Bi ? std::pair{Bi, Si} : bmssp(l - 1, Bi, Si);
         push_state(BMSSP_Event::RecurseExit,l - 1, Bi_prime, dist_cache_, finalized_,Ui,{},-1);
-        U.insert(U.end(), Ui.begin(), Ui.end());
+        // Equal distances let a sub-call settle a vertex an earlier one already returned, count it towards U once
+        for (const auto& p : Ui) {
+            if (U_stamp[p.key_] == call) continue;
+            U_stamp[p.key_] = call;
+            U.push_back(p);
+        }
         push_state(BMSSP_Event::Frontier, l, B_prime, dist_cache_, finalized_,U,{},-1);
 
-        VertexSet K;
+        // Ui is complete, so none of its vertices can be reinserted below: drop them from D before relaxing
+        BMSSP_STATS_ONLY(phase.restart();)
         for (const auto& [u, du] : Ui) {
             D.erase(u);
-            last_complete_level_[u->id_] = l;
-            finalized_[u->id_] = true;
-            for (const auto& [v_id, w_uv] : u->outgoing_edges_) {
-                const Vertex *v = graph_.get_vertex(v_id);
-                const double cand = du + w_uv;
-                if (cand <= dist_cache_[v->id_]) {
-                    dist_cache_[v->id_] = cand;
-                    if (cand >= Bi and cand < B) {
-                        D.insert(v, cand);
-                    } else if (cand >= Bi_prime and cand < Bi) {
-                        K.emplace_back(v, cand);
-                    }
-                }
-            }
+            last_complete_level_[u] = l;
+            finalized_[u] = true;
+        }
+        BMSSP_STATS_ONLY(ls.insert_ms += phase.lap(); relaxed_before = counters_.relaxations;)
+        relax_completed(Ui, Bi_prime, Bi, B, relaxed, inserts, prepends);
+        BMSSP_STATS_ONLY(ls.relax_ms += phase.lap(); ls.completed_relaxations += counters_.relaxations - relaxed_before;)
+
+        VertexSet batch;
+        for (const auto& part : inserts) {
+            batch.insert(batch.end(), part.begin(), part.end());
+        }
+        BMSSP_STATS_ONLY(phase.restart();)
+        D.batch_insert(batch);
+        BMSSP_STATS_ONLY(ls.insert_ms += phase.lap();)
+
+        VertexSet K;
+        for (const auto& part : prepends) {
+            K.insert(K.end(), part.begin(), part.end());
         }
         for (const auto& [x, dx] : Si) {
             if (dx >= Bi_prime and dx < Bi) {
                 K.emplace_back(x, dx);
             }
         }
+        BMSSP_STATS_ONLY(phase.restart();)
         D.batch_prepend(K, Bi_prime);
+        BMSSP_STATS_ONLY(ls.prepend_ms += phase.lap();)
         B_prime = Bi_prime;
     }
 
     const double resB = D.empty() ? B : B_prime;
 
     for (const auto& [vtx, dv] : W) {
-        if (last_complete_level_[vtx->id_] != l and dist_cache_[vtx->id_] < resB) {
-            last_complete_level_[vtx->id_] = l;
-            finalized_[vtx->id_] = true;
-            U.emplace_back(vtx, dist_cache_[vtx->id_]);
+        if (last_complete_level_[vtx] != l and U_stamp[vtx] != call and dist_cache_[vtx] < resB) {
+            last_complete_level_[vtx] = l;
+            finalized_[vtx] = true;
+            U.emplace_back(vtx, dist_cache_[vtx]);
         }
     }
+#if BMSSP_STATS
+    ls.dequeue += D.counters();
+    ls.total_ms += total.lap();
+#endif
     push_state(BMSSP_Event::Done, l, resB, dist_cache_, finalized_, U,{},-1);
     return {resB, std::move(U)};
 }
 
-std::vector<double> BMSSP::run() {
+template <SSSPGraph G>
+DequeueIndex& BasicBMSSP<G>::dequeue_index(const int l) {
+    if (dequeue_indices_.size() <= static_cast<size_t>(l)) dequeue_indices_.resize(l + 1);
+    auto& index = dequeue_indices_[l];
+    if (!index) index = std::make_unique<DequeueIndex>(n_);
+    return *index;
+}
+
+template <SSSPGraph G>
+PageVector<uint64_t>& BasicBMSSP<G>::U_stamps(const int l) {
+    // Sub-calls only ever ask for lower levels, so the caller's array is never moved under it
+    if (U_stamps_.size() <= static_cast<size_t>(l)) U_stamps_.resize(l + 1);
+    auto& stamps = U_stamps_[l];
+    if (stamps.empty()) stamps.assign(n_, 0);
+    return stamps;
+}
+
+template <SSSPGraph G>
+std::vector<double> BasicBMSSP<G>::run() {
+    MEMORY_SCOPE(Engine);
     const int l = std::ceil(std::log2(n_) / static_cast<double>(t_));
 
     const VertexSet S = {{source_, 0.0}};
     constexpr double B = INF;
-    dist_cache_[source_->id_] = 0;
+    dist_cache_[source_] = 0;
+    BMSSP_STATS_ONLY(stats_.levels.assign(l + 1, {});)
 
-    push_state(BMSSP_Event::Start, l, B, dist_cache_, finalized_,{S}, {}, source_->id_);
+    push_state(BMSSP_Event::Start, l, B, dist_cache_, finalized_, S, {}, source_);
 
     bmssp(l, B, S);
 
-    return std::move(dist_cache_);
+    // Copied out of the page-backed array, which is released like the moved-from vector used to be
+    std::vector<double> dist(dist_cache_.begin(), dist_cache_.end());
+    dist_cache_ = {};
+    // Every vertex reached is finalized and marked with the level that completed it, which a later bounded_run would
+    // take for its own marks and leave out of its ball
+    std::ranges::fill(last_complete_level_, -1);
+    finalized_.assign(n_, false);
+    return dist;
 }
 
-void BMSSP::push_state(BMSSP_Event type, int level, double B,
-                            const std::vector<double>& dist,
+template <SSSPGraph G>
+std::vector<Pair> BasicBMSSP<G>::bounded_run(const uint64_t src, const double B) {
+    MEMORY_SCOPE(Engine);
+    if (B <= 0) return {};
+    // run() releases dist_cache_
+    if (dist_cache_.size() != n_) dist_cache_.assign(n_, INF);
+    source_ = src;
+    counters_ = {};
+    const int l = std::ceil(std::log2(n_) / static_cast<double>(t_));
+
+    const VertexSet S = {{source_, 0.0}};
+    dist_cache_[source_] = 0;
+    BMSSP_STATS_ONLY(stats_.levels.assign(l + 1, {});)
+    push_state(BMSSP_Event::Start, l, B, dist_cache_, finalized_, S, {}, source_);
+
+    // The top level cap 2^(l t) ≥ n never stops it early, so U is the whole ball. Every distance written is the length
+    // of a path shorter than B, so resetting the entries of U restores the arrays.
+    auto [B_prime, U] = bmssp(l, B, S);
+    for (auto& [v, d_v] : U) {
+        d_v = dist_cache_[v];
+        dist_cache_[v] = INF;
+        last_complete_level_[v] = -1;
+        finalized_[v] = false;
+    }
+    dist_cache_[source_] = INF;
+    return std::move(U);
+}
+
+template <SSSPGraph G>
+void BasicBMSSP<G>::push_state(BMSSP_Event type, int level, double B,
+                            const std::span<const double> dist,
                             const std::vector<bool>& finalized,
-                            VertexSet frontier,
-                            VertexSet pivots,
+                            const std::span<const Pair> frontier,
+                            const std::span<const Pair> pivots,
                             const uint64_t current) {
+    if (trace_) trace_event(type, level, B, frontier.size(), pivots.size());
+    if (!record_frames_) return;
+    MEMORY_SCOPE(Frames);
     BMSSP_Frame f;
     f.event = type;
     f.level = level;
     f.B = B;
-    f.dist = dist;
+    f.dist.assign(dist.begin(), dist.end());
     f.finalized = finalized;
     f.frontier = frontier
-             | std::views::transform([](const Pair& p){ return p.key_->id_; })
+             | std::views::transform([](const Pair& p){ return p.key_; })
              | std::ranges::to<std::vector<uint64_t>>();
     f.pivots = pivots
-            | std::views::transform([](const Pair& p) { return p.key_->id_; })
+            | std::views::transform([](const Pair& p) { return p.key_; })
             | std::ranges::to<std::vector<uint64_t>>();
     f.current = current;
-    frames_.push_back(f);
-}
\ No newline at end of file
+    frames_.push_back(std::move(f));
+}
+
+template <SSSPGraph G>
+void BasicBMSSP<G>::trace_event(const BMSSP_Event type, const int level, const double B, const size_t frontier,
+                                const size_t pivots) {
+    const auto size = static_cast<double>(frontier);
+    switch (type) {
+        case BMSSP_Event::RecurseEnter:
+            trace_->begin("level " + std::to_string(level), {{"S", size}, {"B", B}});
+            break;
+        case BMSSP_Event::Pivots:
+            trace_->instant("pivots", {{"S", size}, {"P", static_cast<double>(pivots)}});
+            break;
+        case BMSSP_Event::Pull:
+            trace_->instant("pull", {{"S", size}, {"B", B}});
+            break;
+        // A base case ends its level 0 call, Done every other one; the frontier is U in both
+        case BMSSP_Event::BaseCase:
+            trace_->end({{"U", size}});
+            break;
+        case BMSSP_Event::Done:
+            trace_->end({{"U", size}, {"B'", B}});
+            break;
+        default:
+            break;
+    }
+}
+
+template class BasicBMSSP<Graph>;
+template class BasicBMSSP<CSRGraph>;
+template class BasicBMSSP<GridGraph>;
+template class BasicBMSSP<GraphSnapshot>;
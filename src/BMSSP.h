@@ -1,7 +1,14 @@
 #ifndef ALGO_SEMINAR_BMSSP_H
 #define ALGO_SEMINAR_BMSSP_H
+#include <memory>
+#include <span>
+
 #include "BlockLinkedList.h"
+#include "BMSSPStats.h"
 #include "Graph.h"
+#include "PageAllocator.h"
+#include "SSSPGraph.h"
+#include "TraceSink.h"
 
 using VertexSet = std::vector<Pair>;
 
@@ -27,45 +34,170 @@ struct BMSSP_Frame {
     uint64_t current = -1;
 };
 
-class BMSSP {
-    Graph& graph_;
-    const Vertex* source_;
+// An edge relaxation: v reached with distance cand from position src of a layer. root is the pivot root of the
+// source, only find_pivots uses it.
+struct Relaxation {
+    uint64_t v;
+    double cand;
+    uint64_t root;
+    size_t src;
+};
+
+// Operation counts of one run, reported next to timings by the parameter tuner
+struct BMSSPCounters {
+    uint64_t pulls = 0;
+    uint64_t base_cases = 0;
+    uint64_t pivot_rounds = 0;
+    uint64_t relaxations = 0;  // edge relaxations that lowered or matched a distance
+};
+
+/*
+BMSSP over any SSSPGraph backend. The definitions live in BMSSP.cpp and are instantiated there for Graph, CSRGraph,
+GridGraph and GraphSnapshot.
+*/
+template <SSSPGraph G>
+class BasicBMSSP {
+    const G& graph_;
+    uint64_t source_;
 
     size_t n_;
     size_t k_;
     size_t t_;
 
+    // Worker threads for the relaxation rounds of find_pivots, 1 runs them serially
+    size_t threads_ = 1;
+    bool record_frames_ = true;
+    TraceSink* trace_ = nullptr;
+    DequeueRecording* dequeue_recording_ = nullptr;
+
     std::vector<BMSSP_Frame> frames_;
     std::vector<bool> finalized_;
-
-    mutable std::vector<uint64_t> pivot_root_cache_;
-    mutable std::vector<size_t> pivot_tree_sz_cache_;
-    mutable std::vector<double> dist_cache_;
-    mutable std::vector<int> last_complete_level_;
+    mutable BMSSPCounters counters_;
+    BMSSP_STATS_ONLY(BMSSPStats stats_;)
+
+    // The O(n) arrays are PageVectors, placed by the pages:: policy
+    mutable PageVector<uint64_t> pivot_root_cache_;
+    mutable PageVector<size_t> pivot_tree_sz_cache_;
+    mutable PageVector<uint8_t> pivot_visited_;
+    mutable PageVector<size_t> claim_owner_;
+    // U_stamps_[l][v] is the number of the level-l bmssp call whose U last took v. One array per level, created on
+    // first use: a sub-call taking v again must not hide from its caller that the caller's U already has it.
+    std::vector<PageVector<uint64_t>> U_stamps_;
+    uint64_t calls_ = 0;
+    mutable PageVector<double> dist_cache_;
+    mutable PageVector<int> last_complete_level_;
+    // Key index of the queue D of each recursion level, created on first use. Only one call per level is active at a
+    // time and every D leaves its index empty, so no call pays for the O(n) index.
+    std::vector<std::unique_ptr<DequeueIndex>> dequeue_indices_;
+
+    DequeueIndex& dequeue_index(int l);
+
+    PageVector<uint64_t>& U_stamps(int l);
 
     void push_state(BMSSP_Event type, int level, double B,
-                            const std::vector<double>& dist,
+                            std::span<const double> dist,
                             const std::vector<bool>& finalized,
-                            VertexSet frontier, VertexSet pivots,
+                            std::span<const Pair> frontier, std::span<const Pair> pivots,
                             uint64_t current);
 
+    void trace_event(BMSSP_Event type, int level, double B, size_t frontier, size_t pivots);
+
+    void relax_layer(const VertexSet& layer, double B, size_t threads,
+                     std::vector<std::vector<Relaxation>>& relaxed) const;
+
+    bool claim(const Relaxation& r) const;
+
+    void relax_round(const VertexSet& W_prev, double B, std::vector<std::vector<Relaxation>>& relaxed,
+                     std::vector<VertexSet>& found, std::vector<VertexSet>& fresh) const;
+
+    void relax_completed(const VertexSet& Ui, double Bi_prime, double Bi, double B,
+                         std::vector<std::vector<Relaxation>>& relaxed, std::vector<VertexSet>& inserts,
+                         std::vector<VertexSet>& prepends) const;
+
     [[nodiscard]]
     std::pair<VertexSet, VertexSet> find_pivots(const VertexSet& S, double B) const;
 
-    std::pair<double, VertexSet> base_case(const Pair& S, double B);
+    std::pair<double, VertexSet> base_case(const VertexSet& S, double B);
 
     std::pair<double, VertexSet> bmssp(int l, double B, const VertexSet& S);
 public:
-    BMSSP(Graph& graph, const Vertex* src);
+    // k and t from the formulas, BMSSPTuner::tuned takes them from the graph's tuning profile instead
+    BasicBMSSP(const G& graph, uint64_t src);
+
+    BasicBMSSP(const G& graph, uint64_t src, size_t k, size_t t);
+
+    BasicBMSSP(const G& graph, const Vertex* src) : BasicBMSSP(graph, src->id_) {}
 
-    BMSSP(Graph& graph, const Vertex* src, size_t k, size_t t);
+    BasicBMSSP(const G& graph, const Vertex* src, const size_t k, const size_t t) : BasicBMSSP(graph, src->id_, k, t) {}
 
     std::vector<double> run();
 
+    /*
+    Every vertex with distance below B from src, in no particular order. All arrays are kept clean between bounded
+    queries, so one engine answers any number of them in time proportional to the region reached instead of n (the
+    first query pays for allocating them). Frames should be off, they copy n-length arrays.
+    */
+    std::vector<Pair> bounded_run(uint64_t src, double B);
+
+    std::vector<Pair> bounded_run(const Vertex* src, const double B) {
+        return bounded_run(src->id_, B);
+    }
+
+    // Relax large layers (find_pivots rounds, completed sets Ui) on up to `threads` threads. The result, pivots
+    // included, does not depend on it.
+    void set_threads(const size_t threads) {
+        threads_ = std::max<size_t>(1, threads);
+    }
+
+    // Frames copy the whole distance array on every event, turn them off for large graphs
+    void set_record_frames(const bool record) {
+        record_frames_ = record;
+    }
+
+    /*
+    Record the recursion into sink, independent of frames: a span per bmssp call named after its level, with |S| and B
+    on entry and |U| and the returned bound on exit, plus instant events for the pivots and every pull. nullptr stops
+    recording; the sink has to outlive the runs it records.
+    */
+    void set_trace(TraceSink* sink) {
+        trace_ = sink;
+    }
+
+    // Log the operations on every queue D of the following runs to recording (nullptr stops), see DequeueRecording
+    void set_dequeue_recording(DequeueRecording* recording) {
+        dequeue_recording_ = recording;
+        if (recording) recording->n = n_;
+    }
+
     std::vector<BMSSP_Frame> frames() const {
         return frames_;
     }
+
+    [[nodiscard]] const BMSSPCounters& counters() const {
+        return counters_;
+    }
+
+    // Per-level statistics of the last run or bounded_run, always empty unless built with BMSSP_STATS
+    [[nodiscard]] const BMSSPStats& stats() const {
+#if BMSSP_STATS
+        return stats_;
+#else
+        static const BMSSPStats empty;
+        return empty;
+#endif
+    }
+
+    [[nodiscard]] size_t k() const {
+        return k_;
+    }
+
+    [[nodiscard]] size_t t() const {
+        return t_;
+    }
 };
 
 
+using BMSSP = BasicBMSSP<Graph>;
+
+
 #endif //ALGO_SEMINAR_BMSSP_H
\ No newline at end of file
@@ -0,0 +1,101 @@
+#ifndef ALGO_SEMINAR_BMSSP_STATS_H
+#define ALGO_SEMINAR_BMSSP_STATS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+/*
+Per-level statistics of BMSSP runs, for finding out where the time goes. Collecting them costs a clock read around
+every phase, so they only exist when BMSSP_STATS is defined to 1 (CMake option BMSSP_STATS). Otherwise every
+BMSSP_STATS_ONLY(...) expands to nothing and neither BasicBMSSP nor DequeueBlocks carries any of it.
+*/
+#ifndef BMSSP_STATS
+#define BMSSP_STATS 0
+#endif
+
+#if BMSSP_STATS
+#define BMSSP_STATS_ONLY(...) __VA_ARGS__
+#else
+#define BMSSP_STATS_ONLY(...)
+#endif
+
+// Operations on one DequeueBlocks, summed over its lifetime
+struct DequeueCounters {
+    uint64_t inserts = 0;
+    uint64_t batch_inserts = 0;  // batch_insert calls
+    uint64_t batch_inserted = 0;  // pairs in them that improved on D
+    uint64_t erases = 0;
+    uint64_t splits = 0;
+    uint64_t batch_prepends = 0;
+    uint64_t prepended = 0;  // pairs left after deduplication
+    uint64_t pulls = 0;
+    uint64_t pulled = 0;
+    uint64_t max_pull = 0;
+
+    DequeueCounters& operator+=(const DequeueCounters& o) {
+        inserts += o.inserts;
+        batch_inserts += o.batch_inserts;
+        batch_inserted += o.batch_inserted;
+        erases += o.erases;
+        splits += o.splits;
+        batch_prepends += o.batch_prepends;
+        prepended += o.prepended;
+        pulls += o.pulls;
+        pulled += o.pulled;
+        max_pull = std::max(max_pull, o.max_pull);
+        return *this;
+    }
+};
+
+// Everything the calls of one recursion level did; level 0 is the base case. Times are wall clock and include the
+// worker threads of the relaxation rounds. total_ms includes the deeper levels, the phase times do not.
+struct BMSSPLevelStats {
+    uint64_t calls = 0;
+    uint64_t find_pivots_calls = 0;
+    uint64_t pivot_rounds = 0;
+    uint64_t pivot_shortcuts = 0;  // find_pivots calls that stopped at |W| > k|S| and returned P = S
+    uint64_t W_total = 0;
+    uint64_t W_max = 0;
+    uint64_t P_total = 0;
+    uint64_t P_max = 0;
+    uint64_t base_cases = 0;
+    uint64_t base_case_settled = 0;  // |U| summed over the base cases
+    uint64_t pivot_relaxations = 0;
+    uint64_t completed_relaxations = 0;  // relax_completed, or the heap of the base case on level 0
+    DequeueCounters dequeue;
+
+    double find_pivots_ms = 0;
+    double base_case_ms = 0;
+    double pull_ms = 0;
+    double relax_ms = 0;
+    double insert_ms = 0;  // insert, batch_insert and erase on D
+    double prepend_ms = 0;
+    double total_ms = 0;
+};
+
+struct BMSSPStats {
+    // levels[l] for every level of the last run, top level last
+    std::vector<BMSSPLevelStats> levels;
+
+    // Wall clock in ms since construction, the last restart or the last lap, whichever came last
+    class Stopwatch {
+        std::chrono::steady_clock::time_point last_ = std::chrono::steady_clock::now();
+
+    public:
+        void restart() {
+            last_ = std::chrono::steady_clock::now();
+        }
+
+        double lap() {
+            const auto now = std::chrono::steady_clock::now();
+            const double ms = std::chrono::duration<double, std::milli>(now - last_).count();
+            last_ = now;
+            return ms;
+        }
+    };
+};
+
+
+#endif //ALGO_SEMINAR_BMSSP_STATS_H
@@ -0,0 +1,145 @@
+#include "BMSSPTuner.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+#include "GraphFactory.h"
+
+std::string GraphFingerprint::key() const {
+    std::ostringstream out;
+    out << "n=" << n << ";arcs=" << arcs << ";maxdeg=" << max_degree << ";hist=";
+    for (size_t b = 0; b < DEGREE_BUCKETS; ++b) {
+        out << (b ? "," : "") << degree_histogram[b];
+    }
+    return out.str();
+}
+
+GraphFingerprint fingerprint(const Graph& graph) {
+    GraphFingerprint fp;
+    fp.n = graph.size();
+    for (const auto& vertex : graph.get_vertices()) {
+        const size_t degree = vertex.outgoing_edges_.size();
+        fp.arcs += degree;
+        fp.max_degree = std::max(fp.max_degree, degree);
+        // bit_width: 0 -> 0, 1 -> 1, 2..3 -> 2, 4..7 -> 3, ...
+        const size_t bucket = std::min<size_t>(std::bit_width(degree), GraphFingerprint::DEGREE_BUCKETS - 1);
+        fp.degree_histogram[bucket]++;
+    }
+    return fp;
+}
+
+namespace {
+
+// Profiles of the profile file, read once and kept in sync by save
+struct ProfileTable {
+    std::mutex mutex;
+    std::string path;
+    bool loaded = false;
+    std::unordered_map<std::string, TuningProfile> profiles;
+
+    void load_locked() {
+        const std::string current = BMSSPTuner::profile_path();
+        if (loaded and current == path) return;
+        path = current;
+        loaded = true;
+        profiles.clear();
+        std::ifstream f(path);
+        std::string key;
+        TuningProfile p{};
+        while (f >> key >> p.k >> p.t >> p.ms) {
+            profiles[key] = p;
+        }
+    }
+
+    void store_locked() const {
+        std::ofstream f(path, std::ios::trunc);
+        for (const auto& [key, p] : profiles) {
+            f << key << ' ' << p.k << ' ' << p.t << ' ' << p.ms << '\n';
+        }
+    }
+};
+
+ProfileTable& profile_table() {
+    static ProfileTable table;
+    return table;
+}
+
+}
+
+BMSSPTuner::BMSSPTuner(Graph& graph, const size_t sources, const size_t threads)
+    : graph_(graph), sources_(std::max<size_t>(1, sources)), threads_(threads) {}
+
+TuningProfile BMSSPTuner::sweep(size_t k_max, size_t t_max) {
+    const auto log_n = std::log2(static_cast<double>(std::max<size_t>(2, graph_.size())));
+    if (k_max == 0) k_max = std::max<size_t>(2, 2 * static_cast<size_t>(std::pow(log_n, 1.0 / 3.0)));
+    if (t_max == 0) t_max = std::max<size_t>(2, 2 * static_cast<size_t>(std::pow(log_n, 2.0 / 3.0)));
+
+    const auto starts = get_start_vertices(graph_, static_cast<int>(std::min(sources_, graph_.size())));
+    samples_.clear();
+    TuningProfile best{0, 0, std::numeric_limits<double>::infinity()};
+
+    for (size_t k = 1; k <= k_max; ++k) {
+        for (size_t t = 1; t <= t_max; ++t) {
+            TuningSample sample{k, t, 0.0, {}};
+            for (const Vertex* src : starts) {
+                BMSSP bmssp(graph_, src, k, t);
+                bmssp.set_record_frames(false);
+                bmssp.set_threads(threads_);
+                const auto start = std::chrono::steady_clock::now();
+                bmssp.run();
+                const auto end = std::chrono::steady_clock::now();
+                sample.ms += std::chrono::duration<double, std::milli>(end - start).count();
+
+                const auto& c = bmssp.counters();
+                sample.counters.pulls += c.pulls;
+                sample.counters.base_cases += c.base_cases;
+                sample.counters.pivot_rounds += c.pivot_rounds;
+                sample.counters.relaxations += c.relaxations;
+            }
+            sample.ms /= static_cast<double>(starts.size());
+            samples_.push_back(sample);
+            if (sample.ms < best.ms) {
+                best = TuningProfile{k, t, sample.ms};
+            }
+        }
+    }
+    return best;
+}
+
+std::string BMSSPTuner::profile_path() {
+    const char* env = std::getenv("BMSSP_PROFILE_FILE");
+    return env != nullptr ? env : "bmssp_profiles.txt";
+}
+
+void BMSSPTuner::save(const Graph& graph, const TuningProfile& profile) {
+    const std::string key = fingerprint(graph).key();
+    auto& table = profile_table();
+    std::lock_guard lock(table.mutex);
+    table.load_locked();
+    table.profiles[key] = profile;
+    table.store_locked();
+}
+
+std::optional<TuningProfile> BMSSPTuner::lookup(const Graph& graph) {
+    auto& table = profile_table();
+    std::lock_guard lock(table.mutex);
+    table.load_locked();
+    // Most runs have no profiles at all, skip the O(n) fingerprint then
+    if (table.profiles.empty()) return std::nullopt;
+    const auto it = table.profiles.find(fingerprint(graph).key());
+    if (it == table.profiles.end()) return std::nullopt;
+    return it->second;
+}
+
+BMSSP BMSSPTuner::tuned(const Graph& graph, const uint64_t src) {
+    if (const auto profile = lookup(graph)) return BMSSP(graph, src, profile->k, profile->t);
+    return BMSSP(graph, src);
+}
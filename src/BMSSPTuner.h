@@ -0,0 +1,80 @@
+#ifndef ALGO_SEMINAR_BMSSP_TUNER_H
+#define ALGO_SEMINAR_BMSSP_TUNER_H
+
+#include <array>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "BMSSP.h"
+#include "Graph.h"
+
+// Identifies a graph by its size and out-degree distribution. Two graphs with the same fingerprint share a tuning
+// profile, e.g. every grid of the same dimensions.
+struct GraphFingerprint {
+    static constexpr size_t DEGREE_BUCKETS = 12;
+
+    size_t n = 0;
+    size_t arcs = 0;  // directed out-edges, undirected edges count twice
+    size_t max_degree = 0;
+    // Vertices with out-degree 0, 1, 2-3, 4-7, ..., ≥ 2^10
+    std::array<size_t, DEGREE_BUCKETS> degree_histogram{};
+
+    [[nodiscard]] std::string key() const;
+
+    bool operator==(const GraphFingerprint&) const = default;
+};
+
+GraphFingerprint fingerprint(const Graph& graph);
+
+struct TuningProfile {
+    size_t k;
+    size_t t;
+    double ms;  // mean wall clock per source
+};
+
+// One (k, t) point of a sweep
+struct TuningSample {
+    size_t k;
+    size_t t;
+    double ms;  // mean wall clock per source
+    BMSSPCounters counters;  // summed over all sources
+};
+
+/*
+Sweeps the BMSSP parameters (k, t) on a sample of sources and keeps the fastest pair per graph fingerprint in a profile
+file. BMSSPTuner::tuned(graph, src) consults the same file, so a graph tuned once runs with its profile from then on;
+plain BMSSP(graph, src) never reads it.
+The file holds one line "<fingerprint key> <k> <t> <ms>" per graph; its path is $BMSSP_PROFILE_FILE or
+bmssp_profiles.txt in the working directory.
+*/
+class BMSSPTuner {
+    Graph& graph_;
+    size_t sources_;
+    size_t threads_;
+    std::vector<TuningSample> samples_;
+
+public:
+    explicit BMSSPTuner(Graph& graph, size_t sources = 8, size_t threads = 1);
+
+    // Time every (k, t) in [1, k_max] x [1, t_max], 0 means twice the formula value for this graph
+    TuningProfile sweep(size_t k_max = 0, size_t t_max = 0);
+
+    [[nodiscard]] const std::vector<TuningSample>& samples() const {
+        return samples_;
+    }
+
+    static std::string profile_path();
+
+    // Store profile for graph, replacing an earlier profile with the same fingerprint
+    static void save(const Graph& graph, const TuningProfile& profile);
+
+    static std::optional<TuningProfile> lookup(const Graph& graph);
+
+    // BMSSP with the profile of graph if there is one, with the formula values otherwise. Reads the profile file and,
+    // if it has profiles, fingerprints the graph in O(n + m).
+    static BMSSP tuned(const Graph& graph, uint64_t src);
+};
+
+
+#endif //ALGO_SEMINAR_BMSSP_TUNER_H
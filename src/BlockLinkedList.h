@@ -3,49 +3,84 @@
 
 #include <algorithm>
 #include <cassert>
-#include <cmath>
+#include <limits>
 #include <list>
 #include <map>
-#include <ranges>
+#include <memory>
+#include <utility>
 
+#include "BMSSPStats.h"
 #include "Graph.h"
+#include "MemoryAccounting.h"
+#include "PageAllocator.h"
+#include "PerfCounters.h"
+#include "SelectKernels.h"
 
 
 struct Pair {
-    const Vertex* key_;
-    double value_;
+    uint64_t key_;  // vertex id
+    double value_;  // exact distance, so bounds compare consistently with the engines' dist arrays
 
-    static constexpr double SCALE = 1e10;
-
-    static double round_value(const double v) {
-        return std::round(v * SCALE) / SCALE;
-    }
-
-    Pair(const Vertex* k, const double v) : key_(k), value_(round_value(v)) {}
-    Pair() : key_(nullptr), value_(0) {}
+    Pair(const uint64_t k, const double v) : key_(k), value_(v) {}
+    Pair() : key_(0), value_(0) {}
 
     bool operator<(const Pair& o) const noexcept {
         if (value_ != o.value_) return value_ < o.value_;
-        return key_->id_ < o.key_->id_;
+        return key_ < o.key_;
     }
 
     bool operator>(const Pair& o) const noexcept {
         if (value_ != o.value_) return value_ > o.value_;
-        return key_->id_ > o.key_->id_;
+        return key_ > o.key_;
+    }
+};
+
+/*
+Operations on the DequeueBlocks of one BMSSP run in the order they happened, to replay them on the queue alone (see
+BasicBMSSP::set_dequeue_recording and bench/structure_bench.cpp). Batches are copied into pairs as they were passed
+in. A pull keeps the size and bound it returned, so a replay can tell whether the queue still behaves the same.
+*/
+enum class DequeueOpKind : uint8_t {Create, Destroy, Insert, BatchInsert, Erase, BatchPrepend, Pull};
+
+struct DequeueOp {
+    DequeueOpKind kind;
+    uint32_t queue;  // queues are numbered in order of creation
+    uint64_t key = 0;  // Insert and Erase; M for Create
+    double value = 0;  // Insert; B for Create, the bound of BatchPrepend and Pull
+    size_t first = 0;  // batches are pairs[first, first + count)
+    size_t count = 0;  // size of a batch or of the set a pull returned
+};
+
+struct DequeueRecording {
+    size_t n = 0;  // key range
+    uint32_t queues = 0;
+    std::vector<DequeueOp> ops;
+    std::vector<Pair> pairs;
+
+    void add_batch(const DequeueOpKind kind, const uint32_t queue, const std::vector<Pair>& batch, const double bound) {
+        ops.push_back({kind, queue, 0, bound, pairs.size(), batch.size()});
+        pairs.insert(pairs.end(), batch.begin(), batch.end());
     }
 };
 
 enum class BlockOwner {D0, D1};
 
+// Block contents are kept as two parallel arrays (structure of arrays), so the selection kernels
+// stream over plain doubles and ids.
 struct Block {
-    std::vector<Pair> elems_;
+    std::vector<double> values_;
+    std::vector<uint64_t> ids_;
     double upper_;
     BlockOwner owner_;
     size_t block_id_;
 
     Block(const double B, const size_t M, const BlockOwner owner, const size_t id) : upper_(B), owner_(owner), block_id_(id) {
-        elems_.reserve(M);
+        values_.reserve(M);
+        ids_.reserve(M);
     }
+
+    [[nodiscard]] size_t size() const { return ids_.size(); }
+    [[nodiscard]] bool empty() const { return ids_.empty(); }
 };
 
 struct BlockRef {
@@ -67,6 +102,22 @@ struct KeyPos {
     size_t elem_idx;
 };
 
+/*
+Key positions of a DequeueBlocks, indexed by key. Only the entries of present keys are meaningful and a queue clears
+the present flags of its remaining keys when it is destroyed, so one index serves any number of queues in sequence
+without being cleared in between. That makes creating a queue independent of the key range N.
+*/
+struct DequeueIndex {
+    PageVector<KeyPos> key_poses;
+    PageVector<uint8_t> present;
+
+    explicit DequeueIndex(const size_t N) {
+        MEMORY_SCOPE(DequeueBlocks);
+        key_poses.resize(N);
+        present.assign(N, 0);
+    }
+};
+
 class DequeueBlocks {
     std::list<Block> D0_;  // Batch-prepend
     std::list<Block> D1_;  // Normal inserts
@@ -77,15 +128,35 @@ class DequeueBlocks {
 
     std::multimap<double, BlockRef> D1_tree_;  // Red-Black Tree for D1 blocks
 
-    // Key bookkeeping
-    std::vector<KeyPos> key_poses_;
-    std::vector<bool> present_;
+    // Key bookkeeping, in an index of its own or one lent by the caller
+    std::unique_ptr<DequeueIndex> own_index_;
+    PageVector<KeyPos>& key_poses_;
+    PageVector<uint8_t>& present_;
+    size_t count_ = 0;
+
+    // Scratch arrays for pull and split, kept to avoid reallocating on every call
+    std::vector<double> cand_values_, scratch_values_;
+    std::vector<uint64_t> cand_ids_, scratch_ids_;
 
     // Params
     size_t M_;
     double B_upper_;
     size_t next_block_id_ = 0;
 
+    // block id tagging keys that are pending inside a batch_prepend buffer
+    static constexpr size_t BATCH_BLOCK_ID = std::numeric_limits<size_t>::max();
+
+    BMSSP_STATS_ONLY(DequeueCounters counters_;)
+    DequeueRecording* recording_ = nullptr;
+    uint32_t recorded_queue_ = 0;
+
+    DequeueBlocks(std::unique_ptr<DequeueIndex> index, const size_t M, const double B)
+        : own_index_(std::move(index)), key_poses_(own_index_->key_poses), present_(own_index_->present), M_(M),
+          B_upper_(B) {
+        MEMORY_SCOPE(DequeueBlocks);
+        create_block(B, BlockOwner::D1);
+    }
+
     // helper methods
     // get D0 or D1 depending on owner
     std::list<Block>& get_deque(const BlockOwner owner) {
@@ -106,33 +177,36 @@ class DequeueBlocks {
         return map[ref.block_id];
     }
 
-    // remove Block from D1-tree
-    void remove_from_D1_tree(const double upper, const BlockRef& ref) {
+    // Entry of a D1 block in D1_tree_
+    std::multimap<double, BlockRef>::iterator find_in_D1_tree(const double upper, const BlockRef& ref) {
         const auto& [fst, snd] = D1_tree_.equal_range(upper);    // find subsequence [fst:snd] matching upper
         for (auto it = fst; it != snd; ++it) {
-            if (it->second.block_id == ref.block_id && it->second.owner == ref.owner) {
-                D1_tree_.erase(it);
-                break;
-            }
+            if (it->second.block_id == ref.block_id && it->second.owner == ref.owner) return it;
         }
+        return D1_tree_.end();
+    }
+
+    // remove Block from D1-tree
+    void remove_from_D1_tree(const double upper, const BlockRef& ref) {
+        if (const auto it = find_in_D1_tree(upper, ref); it != D1_tree_.end()) D1_tree_.erase(it);
     }
 
     BlockRef create_block(const double upper, const BlockOwner owner) {
+        return create_block(upper, owner, D1_tree_.end());
+    }
+
+    // D1 blocks are ordered by D1_tree_ alone, so their position in the D1_ list does not matter. A new D1 block goes
+    // right before `before` among the blocks with the same upper bound, which only matters for ties (see split).
+    BlockRef create_block(const double upper, const BlockOwner owner,
+                          const std::multimap<double, BlockRef>::const_iterator before) {
         size_t id = next_block_id_++;
         std::list<Block>& deque = get_deque(owner);
         auto& map = get_map(owner);
 
+        deque.emplace_back(upper, M_, owner, id);
+        map[id] = std::prev(deque.end());
         if (owner == BlockOwner::D1) {
-            auto it = deque.begin();
-            while (it != deque.end() && it->upper_ < upper) {
-                ++it;
-            }
-            it = deque.insert(it, Block(upper, M_, owner, id));
-            map[id] = it;
-            D1_tree_.emplace(upper, BlockRef{id, owner});
-        } else {
-            deque.emplace_back(upper, M_, owner, id);
-            map[id] = std::prev(deque.end());
+            D1_tree_.emplace_hint(before, upper, BlockRef{id, owner});
         }
         return {id, owner};
     }
@@ -153,59 +227,117 @@ class DequeueBlocks {
 
     void update_key_pos_for_block(const BlockRef& ref) {
         const Block& block = get_block(ref);
-        for (size_t i = 0 ; i < block.elems_.size(); ++i) {
-            const Vertex* key = block.elems_[i].key_;
-            key_poses_[key->id_] = KeyPos(ref, i);
+        for (size_t i = 0 ; i < block.size(); ++i) {
+            key_poses_[block.ids_[i]] = KeyPos(ref, i);
         }
     }
 
-    static Pair find_median_pair(std::vector<Pair>& elems) {
-        assert(!elems.empty());
-        const auto mid = elems.begin() + elems.size() / 2;
-        std::ranges::nth_element(elems, mid, [](const Pair& a, const Pair& b) { return a < b; });
-        return *mid;
+    // swap-remove element idx of a block, fixing the position of the element moved into its place
+    void remove_at(Block& block, const size_t idx) {
+        const size_t last = block.size() - 1;
+        if (idx != last) {
+            block.values_[idx] = block.values_[last];
+            block.ids_[idx] = block.ids_[last];
+            key_poses_[block.ids_[idx]].elem_idx = idx;
+        }
+        block.values_.pop_back();
+        block.ids_.pop_back();
     }
 
-    void finalize_block(const BlockRef& ref) {
-        update_key_pos_for_block(ref);
-        for (const auto& p : get_block(ref).elems_) {
-            present_[p.key_->id_] = true;
+    // Every pull returns through here
+    std::pair<std::vector<Pair>, double> finish_pull(std::vector<Pair> S, const double x) {
+#if BMSSP_STATS
+        ++counters_.pulls;
+        counters_.pulled += S.size();
+        counters_.max_pull = std::max<uint64_t>(counters_.max_pull, S.size());
+#endif
+        if (recording_) recording_->ops.push_back({DequeueOpKind::Pull, recorded_queue_, 0, x, 0, S.size()});
+        return {std::move(S), x};
+    }
+
+    void reserve_scratch(const size_t n) {
+        if (scratch_values_.size() < n) {
+            scratch_values_.resize(n);
+            scratch_ids_.resize(n);
         }
     }
 
+    // Recursively split batch[lo, hi) around its median until every part fits into a block, then copy each part into
+    // a new D0 block placed before pos. Keys in the batch are unique, so Pair::operator< is a strict total order here.
+    void carve_blocks(std::vector<Pair>& batch, const size_t lo, const size_t hi, const size_t target,
+                      const double upper, const std::list<Block>::iterator pos) {
+        if (hi - lo <= target) {
+            const size_t id = next_block_id_++;
+            const auto it = D0_.insert(pos, Block(upper, hi - lo, BlockOwner::D0, id));
+            D0_map_[id] = it;
+            for (size_t i = lo; i < hi; ++i) {
+                it->values_.push_back(batch[i].value_);
+                it->ids_.push_back(batch[i].key_);
+            }
+            update_key_pos_for_block({id, BlockOwner::D0});
+            return;
+        }
+        const size_t mid = lo + (hi - lo) / 2;
+        std::nth_element(batch.begin() + lo, batch.begin() + mid, batch.begin() + hi);
+        carve_blocks(batch, lo, mid, target, upper, pos);
+        carve_blocks(batch, mid, hi, target, upper, pos);
+    }
+
 public:
     // Initialize(M, B)
-    explicit DequeueBlocks(const size_t N, const size_t M, const double B) : M_(M), B_upper_(B) {
-        key_poses_.resize(N);
-        present_.resize(N, false);
+    explicit DequeueBlocks(const size_t N, const size_t M, const double B)
+        : DequeueBlocks(std::make_unique<DequeueIndex>(N), M, B) {}
+
+    // Keys are stored in index, which has to be empty and must outlive the queue
+    DequeueBlocks(DequeueIndex& index, const size_t M, const double B)
+        : key_poses_(index.key_poses), present_(index.present), M_(M), B_upper_(B) {
+        MEMORY_SCOPE(DequeueBlocks);
         // Initialize D1 with a single empty block with upper bound B
         create_block(B, BlockOwner::D1);
     }
 
+    DequeueBlocks(const DequeueBlocks&) = delete;
+    DequeueBlocks& operator=(const DequeueBlocks&) = delete;
+
+    ~DequeueBlocks() {
+        if (recording_) recording_->ops.push_back({DequeueOpKind::Destroy, recorded_queue_});
+        // Leave the index empty for the next queue
+        for (const auto* deque : {&D0_, &D1_}) {
+            for (const Block& block : *deque) {
+                for (const uint64_t id : block.ids_) {
+                    present_[id] = false;
+                }
+            }
+        }
+    }
+
+    // Log this queue and every later operation on it to recording, which has to outlive the queue
+    void set_recording(DequeueRecording* recording) {
+        recording_ = recording;
+        recorded_queue_ = recording->queues++;
+        recording->ops.push_back({DequeueOpKind::Create, recorded_queue_, M_, B_upper_});
+    }
+
     // Insert(a, b)
-    void insert(const Vertex* a, const double b) {
-        const size_t id = a->id_;
+    void insert(const uint64_t id, const double b) {
+        if (recording_) recording_->ops.push_back({DequeueOpKind::Insert, recorded_queue_, id, b});
+        MEMORY_SCOPE(DequeueBlocks);
         // To insert a key/value pair ⟨a, b⟩, we first check the existence of its key a
         if (present_[id]) {
             // If a already exists, we delete original pair ⟨a, b′⟩ and insert new pair ⟨a, b⟩ only when b < b′.
             const auto&[block_ref, elem_idx] = key_poses_[id];
-            const double old_b = get_block(block_ref).elems_[elem_idx].value_;
+            const double old_b = get_block(block_ref).values_[elem_idx];
             if (b >= old_b) return;
-            erase(key_poses_[id], a);
+            erase(key_poses_[id], id);
         }
         // We first locate the appropriate block for it, which is the block with the smallest upper bound greater than or equal to b,
         const auto tree_it = D1_tree_.lower_bound(b);
         BlockRef block_ref;
 
         if (tree_it == D1_tree_.end()) {
-            // Use last block in D1
-            if (!D1_map_.empty()) {
-                const auto& [upper, ref] = *D1_tree_.rbegin();
-                block_ref = ref;
-            } else {
-                // Create new block if D1 is empty
-                block_ref = create_block(b, BlockOwner::D1);
-            }
+            // Every block with upper bound B has been pulled or emptied. Open a new last block instead of raising the
+            // upper bound of an existing one, which could move its elements behind blocks holding larger values.
+            block_ref = create_block(std::max(b, B_upper_), BlockOwner::D1);
         } else {
             block_ref = tree_it->second;
         }
@@ -213,208 +345,158 @@ public:
         Block& block = get_block(block_ref);
 
         // ⟨a, b⟩ is then added to the corresponding linked list in O(1) time
-        block.elems_.emplace_back(a, b);
+        block.values_.push_back(b);
+        block.ids_.push_back(id);
         present_[id] = true;
-
-        // update upper bound
-        if (b > block.upper_) {
-            // erase old tree entry
-            remove_from_D1_tree(block.upper_, block_ref);
-            // refresh upper bound
-            block.upper_ = b;
-            // insert new
-            D1_tree_.emplace(block.upper_, block_ref);
-        }
+        ++count_;
+        BMSSP_STATS_ONLY(++counters_.inserts;)
 
         // save key pos
-        key_poses_[id] = KeyPos{block_ref, block.elems_.size() - 1};
+        key_poses_[id] = KeyPos{block_ref, block.size() - 1};
         // split if block is too large
-        if (block.elems_.size() > M_) split(block_ref);
+        if (block.size() > M_) split(block_ref);
+    }
+
+    /*
+    Insert(a, b) for every pair of the batch, with the same result as one insert per pair. Keys in the batch must be
+    unique. The batch is used as scratch space: pairs that do not improve on a stored value are dropped, the rest is
+    sorted and merged into the D1 blocks in one walk along D1_tree_, so the tree is only searched again after a split.
+    */
+    void batch_insert(std::vector<Pair>& batch) {
+        if (recording_) recording_->add_batch(DequeueOpKind::BatchInsert, recorded_queue_, batch, 0);
+        MEMORY_SCOPE(DequeueBlocks);
+        size_t L = 0;
+        for (const auto& p : batch) {
+            if (present_[p.key_]) {
+                const KeyPos& pos = key_poses_[p.key_];
+                if (get_block(pos.block_ref).values_[pos.elem_idx] <= p.value_) continue;
+                erase(key_poses_[p.key_], p.key_);
+            }
+            batch[L++] = p;
+        }
+        batch.resize(L);
+        BMSSP_STATS_ONLY(++counters_.batch_inserts; counters_.batch_inserted += L;)
+        if (batch.empty()) return;
+        std::sort(batch.begin(), batch.end());
+
+        auto tree_it = D1_tree_.lower_bound(batch.front().value_);
+        for (const auto& [id, b] : batch) {
+            while (tree_it != D1_tree_.end() && tree_it->first < b) ++tree_it;
+            if (tree_it == D1_tree_.end()) {
+                // As in insert, open a new last block. It takes every remaining pair of the batch.
+                create_block(std::max(batch.back().value_, B_upper_), BlockOwner::D1);
+                tree_it = D1_tree_.lower_bound(b);
+            }
+            const BlockRef block_ref = tree_it->second;
+            Block& block = get_block(block_ref);
+            block.values_.push_back(b);
+            block.ids_.push_back(id);
+            present_[id] = true;
+            ++count_;
+            key_poses_[id] = KeyPos{block_ref, block.size() - 1};
+
+            if (block.size() > M_) {
+                // The lower half may now hold values above the next pair, locate its block from scratch
+                split(block_ref);
+                tree_it = D1_tree_.lower_bound(b);
+            }
+        }
     }
 
     // Delete(a, b)
-    void erase(const KeyPos& pos, const Vertex* key) {
+    void erase(const KeyPos& pos, const uint64_t id) {
         BlockRef block_ref = pos.block_ref;
         const size_t elem_idx  = pos.elem_idx;
         // To delete the key/value pair ⟨a, b⟩, we remove it directly from the linked list
         Block& block = get_block(block_ref);
         // Fast removal: swap with last element
-        if (elem_idx != block.elems_.size() - 1) {
-            block.elems_[elem_idx] = block.elems_.back();
-
-            // Update position of the moved element
-            const Vertex* moved_key = block.elems_[elem_idx].key_;
-            key_poses_[moved_key->id_].elem_idx = elem_idx;
-        }
-        // Remove last element
-        block.elems_.pop_back();
-        present_[key->id_] = false;
+        remove_at(block, elem_idx);
+        present_[id] = false;
+        --count_;
+        BMSSP_STATS_ONLY(++counters_.erases;)
 
         // if a block in D1 becomes empty after deletion, we need to remove its upper bound in the binary search tree
-        if (block.elems_.empty()) {
+        if (block.empty()) {
             delete_block(block_ref);
         }
     }
 
-    void erase(const Vertex* v) {
+    void erase(const uint64_t id) {
+        if (recording_) recording_->ops.push_back({DequeueOpKind::Erase, recorded_queue_, id});
         if (empty()) return;
-        if (present_[v->id_]) {
-            const auto pos = key_poses_[v->id_];
-            erase(pos, v);
+        if (present_[id]) {
+            const auto pos = key_poses_[id];
+            erase(pos, id);
         }
     }
 
+    /*
+    Split the block into two halves around its median pair. The smaller half moves into a new block whose upper bound
+    is its largest value; the larger half stays in the original block, which keeps its upper bound and tree entry.
+    The new block is entered right before the original one: with ties its bound can equal that of the original or of
+    the block in front, and only this position keeps every block's values at or above those of the blocks before it.
+    */
     void split(const BlockRef& ref) {
         Block& block = get_block(ref);
+        const size_t n = block.size();
+        const size_t mid = n / 2;
+        BMSSP_STATS_ONLY(++counters_.splits;)
 
-        // Find median PAIR
-        Pair median_pair = find_median_pair(block.elems_);
-
-        // Create new blocks
-        BlockRef left_ref = create_block(median_pair.value_, BlockOwner::D1);
-        BlockRef right_ref = create_block(block.upper_, BlockOwner::D1);
+        reserve_scratch(n);
+        select_kernels::select_kth(block.values_.data(), block.ids_.data(), n, mid,
+                                   scratch_values_.data(), scratch_ids_.data());
 
+        // [0, mid) now holds the smaller half
+        const double left_upper = select_kernels::max_value(block.values_.data(), mid);
+        BlockRef left_ref = create_block(left_upper, BlockOwner::D1, find_in_D1_tree(block.upper_, ref));
         Block& left_block = get_block(left_ref);
-        Block& right_block = get_block(right_ref);
-
-        // Partition using the median pair for comparison
-        for (auto& p : block.elems_) {
-            if (p < median_pair) {  // Use operator< which compares value AND key
-                left_block.elems_.push_back(p);
-            } else {
-                right_block.elems_.push_back(p);
-            }
-        }
-
-        // Delete old block
-        delete_block(ref);
+        left_block.values_.assign(block.values_.begin(), block.values_.begin() + mid);
+        left_block.ids_.assign(block.ids_.begin(), block.ids_.begin() + mid);
+        block.values_.erase(block.values_.begin(), block.values_.begin() + mid);
+        block.ids_.erase(block.ids_.begin(), block.ids_.begin() + mid);
 
         // Update key positions
-        finalize_block(left_ref);
-        finalize_block(right_ref);
+        update_key_pos_for_block(left_ref);
+        update_key_pos_for_block(ref);
     }
 
+    /*
+    BatchPrepend Insert L key/value pairs whose values are all smaller than any value currently in the data structure.
+    Duplicate keys keep their smallest value. The batch is used as scratch space: it is deduplicated in place and then
+    carved into blocks of at most ⌈M/2⌉ elements by recursive median partitioning, in O(L log(L/M)) time.
+    */
     void batch_prepend(std::vector<Pair>& batch, const double b_upper) {
-        std::unordered_map<size_t, Pair> best;
-        for (auto& p : batch) {
-            auto id = p.key_->id_;
-            if (!best.contains(id) || p.value_ < best[id].value_) {
-                best[id] = p;
-            }
-        }
-        batch.clear();
-        for (auto &p: best | std::views::values) batch.push_back(p);
-
-        for (auto& p : batch) {
-            if (present_[p.key_->id_]) {
-                p.key_ = nullptr;
-            }
-        }
-        batch.erase(
-            std::ranges::remove_if(batch,
-                                   [](const Pair& p){ return p.key_ == nullptr; }).begin(),
-            batch.end()
-        );
-
-        const size_t L = batch.size();
-
-        if (L <= M_) {
-            BlockRef ref = create_block(b_upper, BlockOwner::D0);
-            Block& block = get_block(ref);
-            block.elems_ = std::move(batch);
-            finalize_block(ref);
-            return;
-        }
-
-        std::list<std::vector<Pair>> work;
-        work.emplace_back(std::move(batch));
-        const size_t target = (M_ + 1) / 2;  // ⌈M/2⌉
-
-        while (!work.empty()) {
-            auto curr = std::move(work.front());
-            work.pop_front();
-
-            if (curr.size() <= target) {
-                BlockRef ref = create_block(b_upper, BlockOwner::D0);
-                Block& block = get_block(ref);
-                block.elems_ = std::move(curr);
-                finalize_block(ref);
-                continue;
-            }
-
-            // Find median pair
-            Pair median_pair = find_median_pair(curr);
-
-            // Three-way partition
-            std::vector<Pair> lower, equal, upper;
-
-            for (auto& p : curr) {
-                if (p < median_pair) {
-                    lower.push_back(p);
-                } else if (median_pair < p) {
-                    upper.push_back(p);
-                } else {
-                    // p == median_pair (same value AND same key id)
-                    equal.push_back(p);
-                }
-            }
-
-            // Case 1: Both lower and upper are non-empty
-            if (!lower.empty() && !upper.empty()) {
-                // Distribute equal elements to balance
-                size_t total_lower = lower.size() + equal.size();
-                size_t total_upper = upper.size();
-
-                if (total_lower > target || total_upper > target) {
-                    // Need to move some equal elements to upper
-                    while (lower.size() < target && !equal.empty()) {
-                        lower.push_back(equal.back());
-                        equal.pop_back();
-                    }
-                    // Remaining equal goes to upper
-                    for (auto& p : equal) {
-                        upper.push_back(p);
-                    }
-                    equal.clear();
-
-                    // If still too big, recurse
-                    if (lower.size() > target || upper.size() > target) {
-                        work.push_front(std::move(upper));
-                        work.push_front(std::move(lower));
-                    } else {
-                        // Create blocks
-                        if (!lower.empty()) {
-                            BlockRef ref = create_block(b_upper, BlockOwner::D0);
-                            Block& block = get_block(ref);
-                            block.elems_ = std::move(lower);
-                            finalize_block(ref);
-                        }
-                        if (!upper.empty()) {
-                            work.push_front(std::move(upper));
-                        }
-                    }
+        if (recording_) recording_->add_batch(DequeueOpKind::BatchPrepend, recorded_queue_, batch, b_upper);
+        MEMORY_SCOPE(DequeueBlocks);
+        // Deduplicate in place. While a key is pending in the batch, present_ is set and its KeyPos points back into
+        // the batch (tagged with BATCH_BLOCK_ID), so duplicates and keys already stored in D are told apart in O(1).
+        size_t L = 0;
+        for (const auto& p : batch) {
+            const size_t id = p.key_;
+            if (present_[id]) {
+                const KeyPos& pos = key_poses_[id];
+                if (pos.block_ref.block_id == BATCH_BLOCK_ID) {
+                    Pair& pending = batch[pos.elem_idx];
+                    if (p.value_ < pending.value_) pending = p;
                     continue;
                 }
+                if (get_block(pos.block_ref).values_[pos.elem_idx] <= p.value_) continue;
+                erase(key_poses_[id], id);
             }
-
-            // Case 2: All elements are equal (or nearly equal)
-            // Just split in the middle
-            size_t split_point = std::min(target, curr.size() - 1);
-            std::vector<Pair> left, right;
-            left.reserve(split_point);
-            right.reserve(curr.size() - split_point);
-
-            for (size_t i = 0; i < curr.size(); ++i) {
-                if (i < split_point) {
-                    left.push_back(curr[i]);
-                } else {
-                    right.push_back(curr[i]);
-                }
-            }
-
-            work.push_front(std::move(right));
-            work.push_front(std::move(left));
+            present_[id] = true;
+            key_poses_[id] = KeyPos{BlockRef{BATCH_BLOCK_ID, BlockOwner::D0}, L};
+            batch[L++] = p;
         }
+        batch.resize(L);
+        BMSSP_STATS_ONLY(++counters_.batch_prepends; counters_.prepended += L;)
+        if (L == 0) return;
+        count_ += L;
+
+        // New blocks go in front of every existing D0 block, in ascending order
+        const auto front = D0_.begin();
+        const size_t target = L <= M_ ? M_ : (M_ + 1) / 2;  // ⌈M/2⌉
+        carve_blocks(batch, 0, L, target, b_upper, front);
+        batch.clear();
     }
 
     /*
@@ -422,124 +504,126 @@ public:
     bound x that separates S′ from the remaining values in the data structure, in amortized O(|S′|) time.
     Specifically, if there are no remaining values, x should be B. Otherwise, x should satisfy
     max(S′) < x ≤ min(D) where D is the set of elements in the data structure after the pull operation.
+    Exact ties can make that impossible with |S′| ≤ M: if more than M keys share the smallest value, M of them are
+    returned with x equal to their value. They are the smallest keys left, so the caller can settle them directly.
     */
     std::pair<std::vector<Pair>, double> pull() {
+        PERF_SCOPE(Pull);
+        MEMORY_SCOPE(DequeueBlocks);
         std::vector<BlockRef> S0_blocks, S1_blocks;
         size_t count0 = 0, count1 = 0;
 
         // Collect blocks from D0
         for (auto it = D0_.begin(); it != D0_.end() && count0 <= M_; ++it) {
-            if (it->elems_.empty()) continue;
+            if (it->empty()) continue;
             S0_blocks.push_back(BlockRef{it->block_id_, BlockOwner::D0});
-            count0 += it->elems_.size();
+            count0 += it->size();
         }
 
         // Collect blocks from D1 (sorted by upper bound)
         for (auto it = D1_tree_.begin(); it != D1_tree_.end() && count1 <= M_; ++it) {
             Block& block = get_block(it->second);
-            if (block.elems_.empty()) continue;
+            if (block.empty()) continue;
             S1_blocks.push_back(it->second);
-            count1 += get_block(it->second).elems_.size();
+            count1 += block.size();
         }
 
         if (count0 + count1 == 0) {
+            // Only empty blocks are left (at most the initial one), drop them together with their bookkeeping
             D0_.clear();
             D1_.clear();
-            return {{}, B_upper_};
+            D0_map_.clear();
+            D1_map_.clear();
+            D1_tree_.clear();
+            return finish_pull({}, B_upper_);
         }
 
         // Case 1: Total ≤ M elements
         if (count0 + count1 <= M_) {
             std::vector<Pair> S;
-            for (const auto& ref : S0_blocks) {
-                Block& block = get_block(ref);
-                S.insert(S.end(), block.elems_.begin(), block.elems_.end());
-            }
-            for (const auto& ref : S1_blocks) {
-                Block& block = get_block(ref);
-                S.insert(S.end(), block.elems_.begin(), block.elems_.end());
-            }
-
-            // Delete collected blocks
-            for (const auto& ref : S0_blocks) delete_block(ref);
-            for (const auto& ref : S1_blocks) delete_block(ref);
-
-            // Mark as not present
-            for (const auto& p : S) {
-                present_[p.key_->id_] = false;
+            S.reserve(count0 + count1);
+            for (const auto* blocks : {&S0_blocks, &S1_blocks}) {
+                for (const auto& ref : *blocks) {
+                    const Block& block = get_block(ref);
+                    for (size_t i = 0; i < block.size(); ++i) {
+                        S.emplace_back(block.ids_[i], block.values_[i]);
+                        present_[block.ids_[i]] = false;
+                    }
+                    delete_block(ref);
+                }
             }
-
-            return {std::move(S), B_upper_};  // Bound = B when empty
+            count_ -= S.size();
+            return finish_pull(std::move(S), B_upper_);  // Bound = B when empty
         }
 
-        // Case 2: > M elements
-        std::vector<const Pair*> candidates;
-        candidates.reserve(count0 + count1);
-
-        for (const auto& ref : S0_blocks) {
-            Block& block = get_block(ref);
-            for (const auto& p : block.elems_) {
-                candidates.push_back(&p);
-            }
-        }
-        for (const auto& ref : S1_blocks) {
-            Block& block = get_block(ref);
-            for (const auto& p : block.elems_) {
-                candidates.push_back(&p);
+        // Case 2: > M elements, gather the candidates into contiguous value / id arrays
+        const size_t total = count0 + count1;
+        cand_values_.clear();
+        cand_ids_.clear();
+        for (const auto* blocks : {&S0_blocks, &S1_blocks}) {
+            for (const auto& ref : *blocks) {
+                const Block& block = get_block(ref);
+                cand_values_.insert(cand_values_.end(), block.values_.begin(), block.values_.end());
+                cand_ids_.insert(cand_ids_.end(), block.ids_.begin(), block.ids_.end());
             }
         }
 
-        // Find M-th smallest (0-indexed, so candidates[M_] is (M+1)-th)
-        const auto m_th = candidates.begin() + M_;
-        std::ranges::nth_element(candidates, m_th,
-            [](const Pair* a, const Pair* b) { return a->value_ < b->value_; });
+        // Find M-th smallest (0-indexed, so position M_ is the (M+1)-th)
+        reserve_scratch(total);
+        select_kernels::select_kth(cand_values_.data(), cand_ids_.data(), total, M_,
+                                   scratch_values_.data(), scratch_ids_.data());
 
         // The bound x should be the (M+1)-th smallest value
-        double x = candidates[M_]->value_;
+        const double x = cand_values_[M_];
+
+        // max(S′) < x has to hold strictly. If the M-th smallest value ties with x, the tied keys stay in D and S′ is
+        // the keys below x. Only when more than M keys share the smallest value, which no S′ of at most M keys can
+        // separate from D, are M of them handed out with bound x = max(S′).
+        size_t take = M_;
+        if (select_kernels::max_value(cand_values_.data(), M_) == x) {
+            size_t below = 0;
+            for (size_t i = 0; i < M_; ++i) {
+                if (cand_values_[i] < x) {
+                    std::swap(cand_values_[i], cand_values_[below]);
+                    std::swap(cand_ids_[i], cand_ids_[below]);
+                    ++below;
+                }
+            }
+            if (below > 0) take = below;
+        }
 
         std::vector<Pair> result;
-        result.reserve(M_);
+        result.reserve(take);
 
-        // Collect and remove the M smallest elements
-        for (size_t i = 0; i < M_; ++i) {
-            const Pair* p = candidates[i];
-            result.push_back(*p);
+        // Collect and remove the smallest elements
+        for (size_t i = 0; i < take; ++i) {
+            const uint64_t key_id = cand_ids_[i];
+            result.emplace_back(key_id, cand_values_[i]);
 
-            const size_t key_id = p->key_->id_;
-            const auto& key_pos = key_poses_[key_id];
+            const KeyPos key_pos = key_poses_[key_id];
             Block& block = get_block(key_pos.block_ref);
-
-            // Fast removal by swapping
-            if (key_pos.elem_idx < block.elems_.size() - 1) {
-                block.elems_[key_pos.elem_idx] = block.elems_.back();
-                const Vertex* moved_key = block.elems_[key_pos.elem_idx].key_;
-                key_poses_[moved_key->id_].elem_idx = key_pos.elem_idx;
-            }
-            block.elems_.pop_back();
+            remove_at(block, key_pos.elem_idx);
             present_[key_id] = false;
 
             // Delete block if empty
-            if (block.elems_.empty()) {
+            if (block.empty()) {
                 delete_block(key_pos.block_ref);
             }
         }
-
-        return {std::move(result), x};
+        count_ -= take;
+        return finish_pull(std::move(result), x);
     }
 
     [[nodiscard]] bool empty() const {
-        return D0_.empty() && D1_.empty();
+        return count_ == 0;
     }
 
     size_t size() const {
-        size_t count = 0;
-        for (const bool p : present_) if (p) count++;
-        return count;
+        return count_;
     }
 
     // Test helper: Check if vertex is present
-    bool contains(const Vertex* v) const {
-        size_t id = v->id_;
+    bool contains(const uint64_t id) const {
         return id < present_.size() && present_[id];
     }
 
@@ -548,6 +632,12 @@ public:
         return {D0_.size(), D1_.size()};
     }
 
+#if BMSSP_STATS
+    [[nodiscard]] const DequeueCounters& counters() const {
+        return counters_;
+    }
+#endif
+
     KeyPos get_key_position(size_t id) const {
         assert(id < key_poses_.size());
         return key_poses_[id];
@@ -0,0 +1,43 @@
+#include "CSRGraph.h"
+
+#include "MemoryAccounting.h"
+
+CSRGraph::CSRGraph(const Graph& graph) {
+    MEMORY_SCOPE(Graph);
+    offsets_.assign(graph.size() + 1, 0);
+    for (const auto& vertex : graph.get_vertices()) {
+        offsets_[vertex.id_ + 1] = vertex.outgoing_edges_.size();
+    }
+    for (size_t v = 0; v < graph.size(); ++v) {
+        offsets_[v + 1] += offsets_[v];
+    }
+    edges_.reserve(offsets_.back());
+    for (uint64_t v = 0; v < graph.size(); ++v) {
+        const auto& edges = graph.get_vertex(v)->outgoing_edges_;
+        edges_.insert(edges_.end(), edges.begin(), edges.end());
+    }
+}
+
+CSRGraph::CSRGraph(PageVector<size_t> offsets, PageVector<Edge> edges)
+    : offsets_(std::move(offsets)), edges_(std::move(edges)) {}
+
+CSRGraph CSRGraph::reverse(const Graph& graph) {
+    MEMORY_SCOPE(Graph);
+    PageVector<size_t> offsets(graph.size() + 1, 0);
+    for (const auto& vertex : graph.get_vertices()) {
+        for (const auto& edge : vertex.outgoing_edges_) {
+            offsets[edge.to_id_ + 1]++;
+        }
+    }
+    for (size_t v = 0; v < graph.size(); ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+    PageVector<Edge> edges(offsets.back());
+    std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+    for (uint64_t u = 0; u < graph.size(); ++u) {
+        for (const auto& [v, w] : graph.get_vertex(u)->outgoing_edges_) {
+            edges[next[v]++] = Edge(u, w);
+        }
+    }
+    return {std::move(offsets), std::move(edges)};
+}
@@ -0,0 +1,38 @@
+#ifndef ALGO_SEMINAR_CSR_GRAPH_H
+#define ALGO_SEMINAR_CSR_GRAPH_H
+
+#include <span>
+#include <vector>
+
+#include "Graph.h"
+#include "PageAllocator.h"
+
+// Read-only adjacency in compressed sparse row form, the arcs of v are edges_[offsets_[v] .. offsets_[v + 1]). Both
+// arrays are placed by the pages:: policy (PageAllocator.h).
+class CSRGraph {
+    PageVector<size_t> offsets_;
+    PageVector<Edge> edges_;
+
+public:
+    explicit CSRGraph(const Graph& graph);
+
+    CSRGraph(PageVector<size_t> offsets, PageVector<Edge> edges);
+
+    // The arcs of graph turned around: neighbors(v) are the arcs into v, each pointing at its tail
+    static CSRGraph reverse(const Graph& graph);
+
+    [[nodiscard]] size_t size() const {
+        return offsets_.size() - 1;
+    }
+
+    [[nodiscard]] size_t arcs() const {
+        return edges_.size();
+    }
+
+    [[nodiscard]] std::span<const Edge> neighbors(const uint64_t v) const {
+        return {edges_.data() + offsets_[v], edges_.data() + offsets_[v + 1]};
+    }
+};
+
+
+#endif //ALGO_SEMINAR_CSR_GRAPH_H
@@ -0,0 +1,58 @@
+#include "DegreeReduction.h"
+
+#include <algorithm>
+
+DegreeReduction::DegreeReduction(const Graph& graph, const size_t max_degree)
+    : reduced_(GraphType::DIRECTED), original_n_(graph.size()), max_degree_(std::max<size_t>(2, max_degree)) {
+    for (uint64_t id = 0; id < original_n_; ++id) {
+        reduced_.add_vertex(id);
+    }
+    uint64_t next_id = original_n_;
+    const auto add_proxy = [&](const uint64_t owner) {
+        reduced_.add_vertex(next_id);
+        owner_.push_back(owner);
+        return next_id++;
+    };
+
+    // Undirected graphs store each edge as two arcs already, so the reduced graph is directed either way.
+    // Weights are copied unperturbed, they carry the dirt of the input graph.
+    std::vector<uint64_t> level;
+    std::vector<uint64_t> parents;
+    for (const auto& vertex : graph.get_vertices()) {
+        const auto& edges = vertex.outgoing_edges_;
+        if (edges.size() <= max_degree_) {
+            for (const auto& [to, w] : edges) {
+                reduced_.add_edge(vertex.id_, to, w, false);
+            }
+            continue;
+        }
+
+        level.clear();
+        for (size_t i = 0; i < edges.size(); i += max_degree_) {
+            const uint64_t leaf = add_proxy(vertex.id_);
+            for (size_t j = i; j < std::min(i + max_degree_, edges.size()); ++j) {
+                reduced_.add_edge(leaf, edges[j].to_id_, edges[j].weight_, false);
+            }
+            level.push_back(leaf);
+        }
+        while (level.size() > max_degree_) {
+            parents.clear();
+            for (size_t i = 0; i < level.size(); i += max_degree_) {
+                const uint64_t parent = add_proxy(vertex.id_);
+                for (size_t j = i; j < std::min(i + max_degree_, level.size()); ++j) {
+                    reduced_.add_edge(parent, level[j], 0.0, false);
+                }
+                parents.push_back(parent);
+            }
+            std::swap(level, parents);
+        }
+        for (const uint64_t child : level) {
+            reduced_.add_edge(vertex.id_, child, 0.0, false);
+        }
+    }
+}
+
+std::vector<double> DegreeReduction::distances(std::vector<double> reduced_dist) const {
+    reduced_dist.resize(original_n_);
+    return reduced_dist;
+}
@@ -0,0 +1,57 @@
+#ifndef ALGO_SEMINAR_DEGREE_REDUCTION_H
+#define ALGO_SEMINAR_DEGREE_REDUCTION_H
+
+#include <vector>
+
+#include "Graph.h"
+
+/*
+Constant-degree transformation for BMSSP, whose analysis assumes constant out-degree. Every vertex with more than
+max_degree outgoing edges keeps its id but hands its edges to proxy vertices: the edges are split into groups of
+max_degree held by leaf proxies, which hang below the vertex in a max_degree-ary tree of zero-weight edges. The
+paper threads the copies of a vertex on a zero-weight cycle instead, the tree keeps the number of extra hops
+logarithmic in the degree. Shortest path lengths are unchanged since every proxy is only reachable through its
+vertex at distance 0.
+
+Every split vertex costs about 1/max_degree proxies per edge, so small bounds multiply the vertex count of dense
+graphs; degree_reduction_bench measures the trade-off.
+
+Original vertices keep their ids 0..n-1, proxies get the ids n, n+1, ..., so distances map back by truncation.
+*/
+class DegreeReduction {
+    Graph reduced_;
+    size_t original_n_;
+    size_t max_degree_;
+    // Original vertex every proxy stands for, indexed by id - original_n_
+    std::vector<uint64_t> owner_;
+
+public:
+    DegreeReduction(const Graph& graph, size_t max_degree = 16);
+
+    [[nodiscard]] Graph& reduced() {
+        return reduced_;
+    }
+
+    [[nodiscard]] const Vertex* vertex(const uint64_t original_id) const {
+        return reduced_.get_vertex(original_id);
+    }
+
+    // The vertex of the input graph a vertex of the reduced graph belongs to
+    [[nodiscard]] uint64_t original(const uint64_t id) const {
+        return id < original_n_ ? id : owner_[id - original_n_];
+    }
+
+    [[nodiscard]] size_t proxies() const {
+        return owner_.size();
+    }
+
+    [[nodiscard]] size_t max_degree() const {
+        return max_degree_;
+    }
+
+    // Distances indexed by the ids of the input graph
+    [[nodiscard]] std::vector<double> distances(std::vector<double> reduced_dist) const;
+};
+
+
+#endif //ALGO_SEMINAR_DEGREE_REDUCTION_H
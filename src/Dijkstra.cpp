@@ -4,98 +4,133 @@
 
 #include "BlockLinkedList.h"
 #include "FibHeap.h"
-
-Dijkstra::Dijkstra(Graph& graph, const Vertex* src) : graph_(graph), source_(src) {}
-
-std::vector<double> Dijkstra::fib_heap_run() const {
+#include "CSRGraph.h"
+#include "GridGraph.h"
+#include "MemoryAccounting.h"
+#include "MutableGraph.h"
+#include "PageAllocator.h"
+#include "RelaxKernels.h"
+
+template <SSSPGraph G>
+BasicDijkstra<G>::BasicDijkstra(const G& graph, const uint64_t src) : graph_(graph), source_(src) {}
+
+template <SSSPGraph G>
+std::vector<double> BasicDijkstra<G>::fib_heap_run() const {
+    MEMORY_SCOPE(Engine);
     const size_t n = graph_.size();
-    auto& vertices = graph_.get_vertices();
-    std::vector<DijkstraState> states_(n);
-    std::vector<bool> state_exists(n, false);
-    for (const auto& v : vertices) {
-        const Vertex* vertex = &v;
-        states_[vertex->id_] = DijkstraState{std::numeric_limits<double>::infinity(), false, nullptr};
-        state_exists[vertex->id_] = true;
-    }
-    states_[source_->id_].dist_ = 0;
+    // Distances and heap nodes in arrays of their own, so that the relaxation kernel gathers plain distances. A vertex
+    // is extracted once and from then on dist[v] ≤ dist_u ≤ cand rejects its arcs, no finalized flag needed.
+    PageVector<double> dist(n, std::numeric_limits<double>::infinity());
+    PageVector<Node<HeapKey>*> heap_node(n, nullptr);
+    dist[source_] = 0;
     FibHeap<HeapKey> priority_queue;
-    states_[source_->id_].heap_node_ = priority_queue.insert({0, source_});
+    heap_node[source_] = priority_queue.insert({0, source_});
+    if (heap_recording_) heap_recording_->ops.push_back({HeapOpKind::Insert, source_, 0});
 
     while (!priority_queue.empty()) {
         auto [dist_u, u] = priority_queue.extract_min();
-
-        if (states_[u->id_].finalized_ == true)
-            continue;
-
-        states_[u->id_].finalized_ = true;
-        states_[u->id_].heap_node_ = nullptr;
-
-        for (const auto& [v_id, weight] : u->outgoing_edges_) {
-            const Vertex* v = graph_.get_vertex(v_id);
-            if (states_[v->id_].finalized_)
-                continue;
-
-            const double new_weight = states_[u->id_].dist_ + weight;
-            if (new_weight < states_[v->id_].dist_) {
-                HeapKey v_key{new_weight, v};
-                const auto v_node = states_[v->id_].heap_node_;
-                if (v_node == nullptr) {
-                    states_[v->id_].heap_node_ = priority_queue.insert(v_key);
-                } else {
-                    priority_queue.decrease_key(v_node, v_key);
-                }
-                states_[v->id_].dist_ = new_weight;
+        if (heap_recording_) heap_recording_->ops.push_back({HeapOpKind::ExtractMin, u, dist_u});
+        heap_node[u] = nullptr;
+
+        relax_kernels::relax<false>(graph_.neighbors(u), dist_u, std::numeric_limits<double>::infinity(), dist.data(),
+                                    [&](const uint64_t v, const double new_weight) {
+            HeapKey v_key{new_weight, v};
+            const auto v_node = heap_node[v];
+            if (v_node == nullptr) {
+                heap_node[v] = priority_queue.insert(v_key);
+            } else {
+                priority_queue.decrease_key(v_node, v_key);
             }
-        }
+            if (heap_recording_) {
+                const auto kind = v_node ? HeapOpKind::DecreaseKey : HeapOpKind::Insert;
+                heap_recording_->ops.push_back({kind, v, new_weight});
+            }
+            dist[v] = new_weight;
+        });
     }
 
-    std::vector<double> result(n);
-    for (size_t i = 0; i < states_.size(); ++i)
-        result[i] = states_[i].dist_;
-
-    return result;
+    return {dist.begin(), dist.end()};
 }
 
-std::vector<double> Dijkstra::std_heap_run() {
+template <SSSPGraph G>
+std::vector<double> BasicDijkstra<G>::std_heap_run() {
+    MEMORY_SCOPE(Engine);
     states_.clear();
 
     const size_t n = graph_.size();
     std::vector<double> dist(n, std::numeric_limits<double>::infinity());
     std::vector<bool> finalized(n, false);
 
-    dist[source_->id_] = 0.0;
+    dist[source_] = 0.0;
 
     std::priority_queue<Pair, std::vector<Pair>, std::greater<>> pq;
     pq.emplace(source_, 0.0);
-    states_.push_back(make_state(EventType::Start, dist, finalized, pq, -1));
+    if (record_frames_) {
+        MEMORY_SCOPE(Frames);
+        states_.push_back(make_state(EventType::Start, dist, finalized, pq, -1));
+    }
 
     while (!pq.empty()) {
         auto [u, dist_u] = pq.top();
         pq.pop();
 
-        if (finalized[u->id_])
+        if (finalized[u])
             continue;
 
-        finalized[u->id_] = true;
-        states_.push_back(make_state(EventType::Done, dist, finalized, pq, u->id_));
-
-        for (const auto& [v_id, w_uv] : u->outgoing_edges_) {
-            if (finalized[v_id]) continue;
+        finalized[u] = true;
+        if (record_frames_) {
+            MEMORY_SCOPE(Frames);
+            states_.push_back(make_state(EventType::Done, dist, finalized, pq, u));
+        }
 
-            const double cand = dist_u + w_uv;
-            if (cand < dist[v_id]) {
-                dist[v_id] = cand;
-                pq.emplace(graph_.get_vertex(v_id), cand);
+        // A finalized v has dist[v] ≤ dist_u ≤ cand, the strict test skips it without reading finalized
+        relax_kernels::relax<false>(graph_.neighbors(u), dist_u, std::numeric_limits<double>::infinity(), dist.data(),
+                                    [&](const uint64_t v_id, const double cand) {
+            dist[v_id] = cand;
+            pq.emplace(v_id, cand);
 
-                states_.push_back(make_state(EventType::Relax, dist, finalized, pq, u->id_));
+            if (record_frames_) {
+                MEMORY_SCOPE(Frames);
+                states_.push_back(make_state(EventType::Relax, dist, finalized, pq, u));
             }
-        }
+        });
     }
 
     return dist;
 }
 
-DijkstraFrame Dijkstra::make_state(EventType type, const std::vector<double> &dist, const std::vector<bool> &finalized, std::priority_queue<Pair, std::vector<Pair>, std::greater<> > pq, const uint64_t current) {
+template <SSSPGraph G>
+std::vector<Pair> BasicDijkstra<G>::bounded_run(const double B, SparseDistances& ws) const {
+    MEMORY_SCOPE(Engine);
+    ws.clear();
+    std::vector<Pair> reached;
+    if (B <= 0) return reached;
+
+    std::priority_queue<Pair, std::vector<Pair>, std::greater<>> pq;
+    ws.set(source_, 0.0);
+    pq.emplace(source_, 0.0);
+
+    while (!pq.empty()) {
+        const auto [u, dist_u] = pq.top();
+        pq.pop();
+        // Stale entry, u was lowered after this push
+        if (dist_u != ws.get(u)) continue;
+        reached.emplace_back(u, dist_u);
+
+        relax_kernels::for_each_prefetched(graph_.neighbors(u), [&](const uint64_t v_id) { ws.prefetch(v_id); },
+                                           [&](const uint64_t v_id, const double w_uv) {
+            const double cand = dist_u + w_uv;
+            if (cand < B and cand < ws.get(v_id)) {
+                ws.set(v_id, cand);
+                pq.emplace(v_id, cand);
+            }
+        });
+    }
+    return reached;
+}
+
+template <SSSPGraph G>
+DijkstraFrame BasicDijkstra<G>::make_state(EventType type, const std::vector<double> &dist, const std::vector<bool> &finalized, std::priority_queue<Pair, std::vector<Pair>, std::greater<> > pq, const uint64_t current) {
     DijkstraFrame s;
     s.event = type;
     s.dist = dist;
@@ -103,8 +138,13 @@ DijkstraFrame Dijkstra::make_state(EventType type, const std::vector<double> &di
     s.current = current;
 
     while (!pq.empty()) {
-        s.pq_vertices.push_back(pq.top().key_->id_);
+        s.pq_vertices.push_back(pq.top().key_);
         pq.pop();
     }
     return s;
 }
+
+template class BasicDijkstra<Graph>;
+template class BasicDijkstra<CSRGraph>;
+template class BasicDijkstra<GridGraph>;
+template class BasicDijkstra<GraphSnapshot>;
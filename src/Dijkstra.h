@@ -10,27 +10,32 @@
 #include "Graph.h"
 #include "FibHeap.h"
 #include "BlockLinkedList.h"
+#include "SparseDistances.h"
+#include "SSSPGraph.h"
 
 
 struct HeapKey {
     double dist;
-    const Vertex* v;
+    uint64_t v;
 
     bool operator<(const HeapKey& key) const {
         return this->dist < key.dist;
     }
 };
 
-struct DijkstraState {
-    double dist_ = std::numeric_limits<double>::infinity();
-    bool finalized_ = false;
-    Node<HeapKey>* heap_node_ = nullptr;
+// Heap operations of one fib_heap_run in order, to replay them on a heap alone (bench/structure_bench.cpp). key is
+// the new key of Insert and DecreaseKey and the key ExtractMin returned.
+enum class HeapOpKind : uint8_t {Insert, DecreaseKey, ExtractMin};
 
-    bool operator<(const DijkstraState& ds) const {
-        return this->dist_ < ds.dist_;
-    }
-    bool operator==(const DijkstraState& ds) = delete;
-    bool operator>(const DijkstraState& ds) = delete;
+struct HeapOp {
+    HeapOpKind kind;
+    uint64_t v;
+    double key;
+};
+
+struct HeapRecording {
+    size_t n = 0;  // vertex range
+    std::vector<HeapOp> ops;
 };
 
 enum class EventType {
@@ -49,25 +54,52 @@ struct DijkstraFrame {
     uint64_t current = -1;
 };
 
-class Dijkstra {
+/*
+Dijkstra over any SSSPGraph backend. The definitions live in Dijkstra.cpp and are instantiated there for Graph,
+CSRGraph, GridGraph and GraphSnapshot.
+*/
+template <SSSPGraph G>
+class BasicDijkstra {
 private:
-    Graph& graph_;
-    const Vertex *source_;
+    const G& graph_;
+    uint64_t source_;
     std::vector<DijkstraFrame> states_;
+    bool record_frames_ = true;
+    HeapRecording* heap_recording_ = nullptr;
 
     static DijkstraFrame make_state(EventType type, const std::vector<double>& dist, const std::vector<bool>& finalized, std::priority_queue<Pair, std::vector<Pair>, std::greater<>> pq, uint64_t current);
 
 public:
-    explicit Dijkstra(Graph& graph, const Vertex* src);
+    BasicDijkstra(const G& graph, uint64_t src);
+
+    BasicDijkstra(const G& graph, const Vertex* src) : BasicDijkstra(graph, src->id_) {}
 
     [[nodiscard]] std::vector<double> fib_heap_run() const;
 
     [[nodiscard]] std::vector<double> std_heap_run();
 
+    // Every vertex with distance below B, in order of distance. ws holds the tentative distances and is cleared on
+    // entry, so a workspace reused across queries makes the cost proportional to the region reached.
+    [[nodiscard]] std::vector<Pair> bounded_run(double B, SparseDistances& ws) const;
+
+    // Frames copy the whole distance array on every event, turn them off outside the visualisation
+    void set_record_frames(const bool record) {
+        record_frames_ = record;
+    }
+
+    // Log the heap operations of the following fib_heap_runs to recording, nullptr stops
+    void set_heap_recording(HeapRecording* recording) {
+        heap_recording_ = recording;
+        if (recording) recording->n = graph_.size();
+    }
+
     [[nodiscard]] std::vector<DijkstraFrame> frames() const {
         return states_;
     }
 };
 
 
+using Dijkstra = BasicDijkstra<Graph>;
+
+
 #endif //ALGO_SEMINAR_DIJKSTRA_H
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include "DynamicSSSP.h"
+
+#include <algorithm>
+#include <functional>
+
+DynamicSSSP::DynamicSSSP(Graph& graph, const Vertex* src)
+    : graph_(graph), source_(src), n_(graph.size()), dist_(n_, std::numeric_limits<double>::infinity()),
+      parent_(n_, NO_PARENT), in_offsets_(n_ + 1, 0), touched_(n_, 0), affected_(n_, 0) {
+    for (const auto& vertex : graph_.get_vertices()) {
+        for (const auto& edge : vertex.outgoing_edges_) {
+            in_offsets_[edge.to_id_ + 1]++;
+        }
+    }
+    for (size_t v = 0; v < n_; ++v) {
+        in_offsets_[v + 1] += in_offsets_[v];
+    }
+    in_from_.resize(in_offsets_[n_]);
+    in_index_.resize(in_offsets_[n_]);
+    std::vector<size_t> fill(in_offsets_.begin(), in_offsets_.end() - 1);
+    for (const auto& vertex : graph_.get_vertices()) {
+        const auto& edges = vertex.outgoing_edges_;
+        for (size_t i = 0; i < edges.size(); ++i) {
+            const size_t slot = fill[edges[i].to_id_]++;
+            in_from_[slot] = vertex.id_;
+            in_index_[slot] = static_cast<uint32_t>(i);
+        }
+    }
+
+    RepairStats stats;
+    ++epoch_;
+    dist_[source_->id_] = 0;
+    std::vector<Pair> heap = {{source_->id_, 0.0}};
+    settle(heap, stats);
+}
+
+double DynamicSSSP::arc_weight(const uint64_t from, const uint64_t to) const {
+    double w = std::numeric_limits<double>::infinity();
+    for (const auto& [v, w_v] : graph_.get_vertex(from)->outgoing_edges_) {
+        if (v == to) w = std::min(w, w_v);
+    }
+    return w;
+}
+
+void DynamicSSSP::touch(const uint64_t v, RepairStats& stats) {
+    if (touched_[v] == epoch_) return;
+    touched_[v] = epoch_;
+    stats.touched++;
+}
+
+void DynamicSSSP::settle(std::vector<Pair>& heap, RepairStats& stats) {
+    std::make_heap(heap.begin(), heap.end(), std::greater<>());
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<>());
+        const auto [u, dist_u] = heap.back();
+        heap.pop_back();
+        // Stale entry, u was lowered again after this push
+        if (dist_u != dist_[u]) continue;
+
+        for (const auto& [v, w_uv] : graph_.get_vertex(u)->outgoing_edges_) {
+            stats.relaxations++;
+            const double cand = dist_u + w_uv;
+            if (cand < dist_[v]) {
+                dist_[v] = cand;
+                parent_[v] = u;
+                touch(v, stats);
+                heap.emplace_back(v, cand);
+                std::push_heap(heap.begin(), heap.end(), std::greater<>());
+            }
+        }
+    }
+}
+
+RepairStats DynamicSSSP::apply(const std::vector<EdgeUpdate>& updates) {
+    RepairStats stats;
+    stats.updates = updates.size();
+    ++epoch_;
+
+    // The arcs whose weight changed, both directions of an undirected edge
+    std::vector<std::pair<uint64_t, uint64_t>> arcs;
+    arcs.reserve(2 * updates.size());
+    for (const auto& [from, to, weight] : updates) {
+        graph_.set_edge_weight(from, to, weight);
+        arcs.emplace_back(from, to);
+        if (graph_.type() == GraphType::UNDIRECTED and from != to) arcs.emplace_back(to, from);
+    }
+
+    // Increases: a tree edge that no longer reproduces the distance of its head invalidates the head's subtree.
+    // Every other distance is still the length of an existing path.
+    std::vector<uint64_t> stack;
+    for (const auto& [a, b] : arcs) {
+        if (parent_[b] != a or affected_[b] == epoch_) continue;
+        if (dist_[a] + arc_weight(a, b) > dist_[b]) {
+            affected_[b] = epoch_;
+            stack.push_back(b);
+        }
+    }
+    std::vector<uint64_t> region;
+    while (!stack.empty()) {
+        const uint64_t x = stack.back();
+        stack.pop_back();
+        region.push_back(x);
+        for (const auto& [y, w] : graph_.get_vertex(x)->outgoing_edges_) {
+            if (parent_[y] == x and affected_[y] != epoch_) {
+                affected_[y] = epoch_;
+                stack.push_back(y);
+            }
+        }
+    }
+    stats.affected = region.size();
+    for (const uint64_t x : region) {
+        dist_[x] = std::numeric_limits<double>::infinity();
+        parent_[x] = NO_PARENT;
+        touch(x, stats);
+    }
+
+    // Seed the reset region from its boundary, reset in-neighbours contribute inf until they are settled
+    std::vector<Pair> heap;
+    for (const uint64_t x : region) {
+        for (size_t i = in_offsets_[x]; i < in_offsets_[x + 1]; ++i) {
+            const uint64_t y = in_from_[i];
+            const double cand = dist_[y] + graph_.get_vertex(y)->outgoing_edges_[in_index_[i]].weight_;
+            if (cand < dist_[x]) {
+                dist_[x] = cand;
+                parent_[x] = y;
+            }
+        }
+        if (dist_[x] < std::numeric_limits<double>::infinity()) heap.emplace_back(x, dist_[x]);
+    }
+
+    // Decreases: seed the heads of arcs that now offer a shorter path
+    for (const auto& [a, b] : arcs) {
+        const double cand = dist_[a] + arc_weight(a, b);
+        if (cand < dist_[b]) {
+            dist_[b] = cand;
+            parent_[b] = a;
+            touch(b, stats);
+            heap.emplace_back(b, cand);
+        }
+    }
+
+    settle(heap, stats);
+    return stats;
+}
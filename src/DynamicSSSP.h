@@ -0,0 +1,81 @@
+#ifndef ALGO_SEMINAR_DYNAMIC_SSSP_H
+#define ALGO_SEMINAR_DYNAMIC_SSSP_H
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "BlockLinkedList.h"
+#include "Graph.h"
+
+// New weight for the edge from -> to, applied with Graph::set_edge_weight
+struct EdgeUpdate {
+    uint64_t from;
+    uint64_t to;
+    double weight;
+};
+
+struct RepairStats {
+    size_t updates = 0;
+    size_t affected = 0;  // vertices whose shortest-path tree branch got longer and were reset
+    size_t touched = 0;  // affected vertices plus every vertex whose distance was lowered during the repair
+    size_t relaxations = 0;
+};
+
+/*
+Single-source distances that follow edge weight changes, Ramalingam–Reps style. Next to the distances it keeps the
+shortest-path tree and a reverse adjacency. A batch of updates is repaired in two steps:
+    - increases: every vertex below a tree edge that got longer is reset and re-seeded from its in-neighbours outside
+      the reset region,
+    - decreases: the head of every edge that now offers a shorter path is seeded with it,
+and one Dijkstra pass from the seeds settles the region that actually changed. Vertices away from it are not looked at.
+The in-arcs are fixed at construction, the graph may change weights but must not gain edges.
+*/
+class DynamicSSSP {
+    static constexpr uint64_t NO_PARENT = std::numeric_limits<uint64_t>::max();
+
+    Graph& graph_;
+    const Vertex* source_;
+    size_t n_;
+
+    std::vector<double> dist_;
+    std::vector<uint64_t> parent_;
+
+    // Reverse adjacency as CSR: the arcs into v are (in_from_[i], in_index_[i]) for i in [in_offsets_[v],
+    // in_offsets_[v + 1]), in_index_ being the position of the arc in the tail's outgoing_edges_ so that the current
+    // weight is read from the graph
+    std::vector<size_t> in_offsets_;
+    std::vector<uint64_t> in_from_;
+    std::vector<uint32_t> in_index_;
+
+    // Vertices touched in the current repair carry its epoch
+    std::vector<uint64_t> touched_;
+    std::vector<uint64_t> affected_;
+    uint64_t epoch_ = 0;
+
+    // Lightest arc from -> to under the current weights
+    [[nodiscard]] double arc_weight(uint64_t from, uint64_t to) const;
+
+    void touch(uint64_t v, RepairStats& stats);
+
+    // Dijkstra from the seeded heap, a vertex is scanned once per distance it is popped with
+    void settle(std::vector<Pair>& heap, RepairStats& stats);
+
+public:
+    DynamicSSSP(Graph& graph, const Vertex* src);
+
+    // Apply the weight changes to the graph and repair the distances
+    RepairStats apply(const std::vector<EdgeUpdate>& updates);
+
+    [[nodiscard]] const std::vector<double>& distances() const {
+        return dist_;
+    }
+
+    // Tree parent of every reached vertex, UINT64_MAX for the source and unreached vertices
+    [[nodiscard]] const std::vector<uint64_t>& parents() const {
+        return parent_;
+    }
+};
+
+
+#endif //ALGO_SEMINAR_DYNAMIC_SSSP_H
@@ -6,6 +6,8 @@
 #include <algorithm>
 
 #include "FibHeap.h"
+#include "MemoryAccounting.h"
+#include "PerfCounters.h"
 #include <cmath>
 #include <stdexcept>
 #include <vector>
@@ -30,6 +32,8 @@ void FibHeap<T>::delete_subtree(Node<T>* x) {
 
 template<typename T>
 void FibHeap<T>::consolidate() {
+    PERF_SCOPE(Consolidate);
+    MEMORY_SCOPE(FibHeap);
     const double phi = (1.0 + std::sqrt(5.0)) / 2.0;
     size_t D = static_cast<size_t>(std::log(n_) / std::log(phi)) + 2;
 
@@ -138,6 +142,7 @@ const T& FibHeap<T>::min() const {
 
 template<typename T>
 Node<T>* FibHeap<T>::insert(const T& key) {
+    MEMORY_SCOPE(FibHeap);
     auto* x = new Node<T>(key);
     if (!min_root_) {
         min_root_ = x;
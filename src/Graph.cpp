@@ -1,6 +1,8 @@
 #include "Graph.h"
 
 #include <cstdlib>
+
+#include "MemoryAccounting.h"
 #define INDEX(y, x, width) ((y) * width + x)
 
 Graph::Graph(const GraphType type) : type_(type) {
@@ -12,7 +14,7 @@ Graph::Graph(const int width, const int height) : type_(GraphType::UNDIRECTED) {
         this->add_vertex(i);
     }
     for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < height; ++x) {
+        for (int x = 0; x < width; ++x) {
             // North
             if (y - 1 >= 0)
                 this->add_edge(INDEX(y, x, width), INDEX(y - 1, x, width), 1.0);
@@ -32,14 +34,17 @@ Graph::Graph(const int width, const int height) : type_(GraphType::UNDIRECTED) {
 void Graph::add_vertex(const uint64_t id) {
     if (id < id_map_.size())
         return;
+    MEMORY_SCOPE(Graph);
     vertices_.emplace_back(id);
     id_map_.resize(id + 1);
     id_map_[id] = &vertices_.back();
+    ++version_;
 }
 
-void Graph::add_edge(const uint64_t from_id, const uint64_t to_id, const double weight) {
+void Graph::add_edge(const uint64_t from_id, const uint64_t to_id, const double weight, const bool perturb) {
+    MEMORY_SCOPE(Graph);
     Vertex* v = id_map_.at(from_id);
-    const double dirt =  static_cast<double>(rand() % 10000) / 1E8;
+    const double dirt = perturb ? static_cast<double>(rand() % 10000) / 1E8 : 0.0;
     if (type_ == GraphType::DIRECTED) {
         v->outgoing_edges_.emplace_back(to_id, weight + dirt);
     } else {
@@ -48,6 +53,29 @@ void Graph::add_edge(const uint64_t from_id, const uint64_t to_id, const double
         u->outgoing_edges_.emplace_back(from_id, weight + dirt);
     }
     ++num_edges_;
+    ++version_;
+}
+
+size_t Graph::set_edge_weight(const uint64_t from_id, const uint64_t to_id, const double weight) {
+    size_t changed = 0;
+    for (auto& edge : id_map_.at(from_id)->outgoing_edges_) {
+        if (edge.to_id_ != to_id) continue;
+        edge.weight_ = weight;
+        ++changed;
+    }
+    if (type_ == GraphType::UNDIRECTED and from_id != to_id) {
+        for (auto& edge : id_map_.at(to_id)->outgoing_edges_) {
+            if (edge.to_id_ != from_id) continue;
+            edge.weight_ = weight;
+            ++changed;
+        }
+    }
+    if (changed > 0) ++version_;
+    return changed;
+}
+
+GraphType Graph::type() const {
+    return type_;
 }
 
 const std::deque<Vertex> &Graph::get_vertices() const {
@@ -68,4 +96,8 @@ size_t Graph::size() const {
 
 size_t Graph::edges_size() const {
     return num_edges_;
-}
\ No newline at end of file
+}
+
+uint64_t Graph::version() const {
+    return version_;
+}
@@ -9,6 +9,7 @@ struct Edge {
     uint64_t to_id_;
     double weight_;
 
+    Edge() = default;
     explicit Edge(const uint64_t to, const double weight) : to_id_(to), weight_(weight) {}
 };
 
@@ -31,15 +32,28 @@ private:
     std::deque<Vertex> vertices_;
     std::vector<Vertex*> id_map_;
     size_t num_edges_{};
+    // Bumped by every mutation, results computed on the graph are valid for one version
+    uint64_t version_{};
 
 public:
     Graph(GraphType type);
     Graph(int width, int height);
     void add_vertex(uint64_t id);
-    void add_edge(uint64_t from_id, uint64_t to_id, double weight);
+    // perturb adds a random dirt < 1e-4 to the weight so that path lengths rarely tie, derived graphs that copy
+    // already perturbed weights pass false
+    void add_edge(uint64_t from_id, uint64_t to_id, double weight, bool perturb = true);
+    // Set the weight of every arc from -> to, and of the reverse arcs in an undirected graph, without perturbation.
+    // Returns the number of arcs changed.
+    size_t set_edge_weight(uint64_t from_id, uint64_t to_id, double weight);
+    [[nodiscard]] GraphType type() const;
     [[nodiscard]] const std::deque<Vertex>& get_vertices() const;
     [[nodiscard]] const Vertex* get_vertex(uint64_t id) const;
+    // Out-arcs of vertex id, the access the engines use
+    [[nodiscard]] const std::vector<Edge>& neighbors(const uint64_t id) const {
+        return id_map_[id]->outgoing_edges_;
+    }
     [[nodiscard]] bool empty() const;
     [[nodiscard]] size_t size() const;
     [[nodiscard]] size_t edges_size() const;
+    [[nodiscard]] uint64_t version() const;
 };
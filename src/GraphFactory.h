@@ -2,6 +2,7 @@
 #define GRAPH_FACTORY_H
 #include "Graph.h"
 
+#include <cmath>
 #include <fstream>
 #include <string>
 #include <iostream>
@@ -40,6 +41,58 @@ inline Graph graph_from_csv(const char* filename, GraphType type) {
     return g;
 }
 
+// Directed graph with n vertices and about n * avg_degree edges with weights in [1, 100). A Hamiltonian cycle over
+// the vertices keeps every vertex reachable, the remaining edges connect uniformly random endpoints.
+inline Graph random_graph(const uint64_t n, const double avg_degree, const uint64_t seed = 42) {
+    Graph g(GraphType::DIRECTED);
+    for (uint64_t i = 0; i < n; ++i) {
+        g.add_vertex(i);
+    }
+    std::mt19937_64 gen(seed);
+    std::uniform_int_distribution<uint64_t> vertex_dist(0, n - 1);
+    std::uniform_real_distribution<double> weight_dist(1.0, 100.0);
+
+    for (uint64_t i = 0; i < n; ++i) {
+        g.add_edge(i, (i + 1) % n, weight_dist(gen));
+    }
+    const auto m = static_cast<uint64_t>(static_cast<double>(n) * avg_degree);
+    for (uint64_t e = n; e < m; ++e) {
+        g.add_edge(vertex_dist(gen), vertex_dist(gen), weight_dist(gen));
+    }
+    return g;
+}
+
+// Directed graph with n vertices, about n * avg_degree edges with weights in [1, 100) and a power-law out-degree
+// distribution: vertex i is the tail of an edge with probability proportional to (i + 1)^(-1 / (exponent - 1)), so
+// the degree tail follows P(deg >= x) ~ x^(1 - exponent) and the low ids are hubs. Heads are uniform, a Hamiltonian
+// cycle keeps every vertex reachable.
+inline Graph power_law_graph(const uint64_t n, const double avg_degree, const double exponent = 2.1,
+                             const uint64_t seed = 42) {
+    Graph g(GraphType::DIRECTED);
+    for (uint64_t i = 0; i < n; ++i) {
+        g.add_vertex(i);
+    }
+    std::mt19937_64 gen(seed);
+    std::uniform_int_distribution<uint64_t> vertex_dist(0, n - 1);
+    std::uniform_real_distribution<double> weight_dist(1.0, 100.0);
+
+    std::vector<double> tail_weights(n);
+    const double alpha = 1.0 / (exponent - 1.0);
+    for (uint64_t i = 0; i < n; ++i) {
+        tail_weights[i] = std::pow(static_cast<double>(i + 1), -alpha);
+    }
+    std::discrete_distribution<uint64_t> tail_dist(tail_weights.begin(), tail_weights.end());
+
+    for (uint64_t i = 0; i < n; ++i) {
+        g.add_edge(i, (i + 1) % n, weight_dist(gen));
+    }
+    const auto m = static_cast<uint64_t>(static_cast<double>(n) * avg_degree);
+    for (uint64_t e = n; e < m; ++e) {
+        g.add_edge(tail_dist(gen), vertex_dist(gen), weight_dist(gen));
+    }
+    return g;
+}
+
 inline std::vector<const Vertex*> get_start_vertices(const Graph& g, const int num) {
     auto& vertices = g.get_vertices();
     std::random_device rd;
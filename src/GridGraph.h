@@ -0,0 +1,140 @@
+#ifndef ALGO_SEMINAR_GRID_GRAPH_H
+#define ALGO_SEMINAR_GRID_GRAPH_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <numbers>
+#include <vector>
+
+#include "Graph.h"
+
+enum class GridNeighborhood {Four, Eight};
+
+// The up to 8 out-arcs of a grid cell, generated into a fixed buffer
+class GridNeighbors {
+    std::array<Edge, 8> edges_;
+    uint32_t count_ = 0;
+
+public:
+    void push(const uint64_t to, const double weight) {
+        edges_[count_++] = Edge(to, weight);
+    }
+
+    [[nodiscard]] const Edge* begin() const {
+        return edges_.data();
+    }
+
+    [[nodiscard]] const Edge* end() const {
+        return edges_.data() + count_;
+    }
+
+    [[nodiscard]] size_t size() const {
+        return count_;
+    }
+};
+
+/*
+Grid graph whose arcs are computed instead of stored. Cell (x, y) has id y * width + x like in Graph(width, height)
+and is connected to its 4 (N, S, W, E) or 8 neighbours. An arc weighs 1, √2 on diagonals, unless one of the optional
+weight arrays is set:
+    - cell weights, the cost of entering a cell: w(u -> v) = cell[v], times √2 on diagonals,
+    - edge weights, one per cell and direction in the order of DIRECTIONS: w(u -> v) = edge[u * directions() + d].
+perturb adds the same kind of dirt < 1e-4 as Graph::add_edge, derived from a hash of the two cells so that both arcs
+of an edge agree. BMSSP needs it: exact ties, common on 8-neighbour grids, can stall its recursion. Without weight
+arrays a cell costs nothing, with cell weights 4 bytes.
+*/
+class GridGraph {
+public:
+    struct Direction {
+        int dx;
+        int dy;
+        double length;
+    };
+
+    static constexpr std::array<Direction, 8> DIRECTIONS = {{
+        {0, -1, 1.0}, {0, 1, 1.0}, {-1, 0, 1.0}, {1, 0, 1.0},
+        {-1, -1, std::numbers::sqrt2}, {1, -1, std::numbers::sqrt2},
+        {-1, 1, std::numbers::sqrt2}, {1, 1, std::numbers::sqrt2},
+    }};
+
+private:
+    uint32_t width_;
+    uint32_t height_;
+    uint32_t directions_;
+    bool perturb_;
+    std::vector<float> cell_weights_;
+    std::vector<float> edge_weights_;
+
+    static double dirt(const uint64_t u, const uint64_t v) {
+        // splitmix64 of the unordered pair
+        uint64_t z = std::min(u, v) * 0x9e3779b97f4a7c15ULL + std::max(u, v);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        z ^= z >> 31;
+        return static_cast<double>(z % 10000) / 1E8;
+    }
+
+public:
+    GridGraph(const uint32_t width, const uint32_t height,
+              const GridNeighborhood neighborhood = GridNeighborhood::Four, const bool perturb = true)
+        : width_(width), height_(height), directions_(neighborhood == GridNeighborhood::Four ? 4 : 8),
+          perturb_(perturb) {}
+
+    // One weight per cell, replaces the unit weights
+    void set_cell_weights(std::vector<float> weights) {
+        cell_weights_ = std::move(weights);
+    }
+
+    // directions() weights per cell, replaces the unit and cell weights
+    void set_edge_weights(std::vector<float> weights) {
+        edge_weights_ = std::move(weights);
+    }
+
+    [[nodiscard]] size_t size() const {
+        return static_cast<size_t>(width_) * height_;
+    }
+
+    [[nodiscard]] uint32_t width() const {
+        return width_;
+    }
+
+    [[nodiscard]] uint32_t height() const {
+        return height_;
+    }
+
+    [[nodiscard]] uint32_t directions() const {
+        return directions_;
+    }
+
+    // Heap memory held by the graph
+    [[nodiscard]] size_t bytes() const {
+        return (cell_weights_.capacity() + edge_weights_.capacity()) * sizeof(float);
+    }
+
+    [[nodiscard]] GridNeighbors neighbors(const uint64_t v) const {
+        GridNeighbors out;
+        const auto x = static_cast<int64_t>(v % width_);
+        const auto y = static_cast<int64_t>(v / width_);
+        for (uint32_t d = 0; d < directions_; ++d) {
+            const auto& [dx, dy, length] = DIRECTIONS[d];
+            const int64_t nx = x + dx;
+            const int64_t ny = y + dy;
+            if (nx < 0 or ny < 0 or nx >= width_ or ny >= height_) continue;
+            const auto to = static_cast<uint64_t>(ny * width_ + nx);
+
+            double w = length;
+            if (!edge_weights_.empty()) {
+                w = edge_weights_[v * directions_ + d];
+            } else if (!cell_weights_.empty()) {
+                w = length * cell_weights_[to];
+            }
+            if (perturb_) w += dirt(v, to);
+            out.push(to, w);
+        }
+        return out;
+    }
+};
+
+
+#endif //ALGO_SEMINAR_GRID_GRAPH_H
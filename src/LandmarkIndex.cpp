@@ -0,0 +1,389 @@
+#include "LandmarkIndex.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <concepts>
+#include <queue>
+#include <random>
+
+#include "Dijkstra.h"
+#include "Parallel.h"
+
+static constexpr double INF = std::numeric_limits<double>::infinity();
+static constexpr uint64_t NO_PARENT = std::numeric_limits<uint64_t>::max();
+static constexpr uint32_t U32_UNREACHABLE = std::numeric_limits<uint32_t>::max();
+
+namespace {
+
+// A* heap entry: f = g + lower bound, g the distance from s it was pushed with
+struct AStarEntry {
+    double f;
+    double g;
+    uint64_t v;
+
+    bool operator>(const AStarEntry& o) const noexcept {
+        return f > o.f;
+    }
+};
+
+template <SSSPGraph G>
+std::vector<double> distances_from(const G& graph, const uint64_t src) {
+    BasicDijkstra<G> dijkstra(graph, src);
+    dijkstra.set_record_frames(false);
+    return dijkstra.std_heap_run();
+}
+
+}
+
+LandmarkIndex::LandmarkIndex(const Graph& graph, const size_t landmarks, const LandmarkStrategy strategy,
+                             const LandmarkPrecision precision, const size_t threads, const uint64_t seed)
+    : graph_(graph), n_(graph.size()), directed_(graph.type() == GraphType::DIRECTED), precision_(precision) {
+    const auto start = std::chrono::steady_clock::now();
+    if (directed_) reverse_.emplace(CSRGraph::reverse(graph));
+    std::vector<std::vector<double>> forward, reverse;
+    select(std::min(landmarks, n_), strategy, seed, forward);
+    compute_tables(threads, forward, reverse);
+    store(forward, reverse);
+    build_ms_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+LandmarkIndex::LandmarkIndex(const Graph& graph, std::vector<uint64_t> landmarks, const LandmarkPrecision precision,
+                             const size_t threads)
+    : graph_(graph), n_(graph.size()), directed_(graph.type() == GraphType::DIRECTED), precision_(precision),
+      landmarks_(std::move(landmarks)) {
+    const auto start = std::chrono::steady_clock::now();
+    if (directed_) reverse_.emplace(CSRGraph::reverse(graph));
+    std::vector<std::vector<double>> forward, reverse;
+    compute_tables(threads, forward, reverse);
+    store(forward, reverse);
+    build_ms_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void LandmarkIndex::select(const size_t count, const LandmarkStrategy strategy, const uint64_t seed,
+                           std::vector<std::vector<double>>& forward) {
+    if (count == 0) return;
+    std::mt19937_64 gen(seed);
+    std::uniform_int_distribution<uint64_t> vertex_dist(0, n_ - 1);
+
+    if (strategy == LandmarkStrategy::Farthest) {
+        // Distance to the nearest landmark, from the random start until there is a first landmark
+        std::vector<double> nearest = distances_from(graph_, vertex_dist(gen));
+        while (landmarks_.size() < count) {
+            uint64_t best = NO_PARENT;
+            for (uint64_t v = 0; v < n_; ++v) {
+                if (nearest[v] != INF and (best == NO_PARENT or nearest[v] > nearest[best])) best = v;
+            }
+            // Every reachable vertex is a landmark already
+            if (best == NO_PARENT or (nearest[best] <= 0 and !landmarks_.empty())) break;
+            landmarks_.push_back(best);
+            forward.push_back(distances_from(graph_, best));
+            const auto& table = forward.back();
+            for (uint64_t v = 0; v < n_; ++v) {
+                nearest[v] = landmarks_.size() == 1 ? table[v] : std::min(nearest[v], table[v]);
+            }
+        }
+        return;
+    }
+
+    std::vector<uint64_t> order, parent(n_), best_child(n_);
+    std::vector<size_t> position(n_);
+    std::vector<double> size(n_);
+    std::vector<uint8_t> covered(n_);
+    std::vector<uint8_t> is_landmark(n_, 0);
+    // Roots whose whole tree the bounds already cover, selection gives up after as many as landmarks were asked for
+    size_t misses = 0;
+    while (landmarks_.size() < count and misses < count) {
+        const uint64_t root = vertex_dist(gen);
+        const auto dist = distances_from(graph_, root);
+
+        // Tree vertices by distance from the root
+        order.clear();
+        for (uint64_t v = 0; v < n_; ++v) {
+            if (dist[v] != INF) order.push_back(v);
+        }
+        std::ranges::sort(order, [&dist](const uint64_t a, const uint64_t b) {
+            return dist[a] < dist[b] or (dist[a] == dist[b] and a < b);
+        });
+        for (size_t i = 0; i < order.size(); ++i) {
+            position[order[i]] = i;
+        }
+
+        // Rebuild the shortest-path tree: the parent of v is a vertex before it whose arc lands exactly on dist[v].
+        // Dijkstra computed dist[v] as such a sum, so all but zero weight ties find theirs; the rest become roots of
+        // their own subtree.
+        for (const uint64_t v : order) {
+            parent[v] = NO_PARENT;
+        }
+        for (const uint64_t u : order) {
+            for (const auto& [v, w] : graph_.neighbors(u)) {
+                if (parent[v] == NO_PARENT and v != root and position[v] > position[u] and dist[u] + w == dist[v]) {
+                    parent[v] = u;
+                }
+            }
+        }
+
+        // Weight: how much the landmarks underestimate d(root, v). Forward tables bound it by d(L, v) - d(L, root),
+        // undirected graphs by its absolute value.
+        for (const uint64_t v : order) {
+            double lower = 0;
+            for (const auto& table : forward) {
+                if (table[v] == INF or table[root] == INF) continue;
+                const double diff = table[v] - table[root];
+                lower = std::max(lower, directed_ ? diff : std::abs(diff));
+            }
+            size[v] = std::max(0.0, dist[v] - lower);
+            covered[v] = is_landmark[v];
+            best_child[v] = NO_PARENT;
+        }
+        // Subtree sums, children first. A subtree holding a landmark weighs nothing.
+        for (size_t i = order.size(); i-- > 0;) {
+            const uint64_t v = order[i];
+            if (covered[v]) size[v] = 0;
+            const uint64_t p = parent[v];
+            if (p == NO_PARENT) continue;
+            if (covered[v]) {
+                covered[p] = 1;
+            } else {
+                size[p] += size[v];
+            }
+        }
+        for (const uint64_t v : order) {
+            const uint64_t p = parent[v];
+            if (p != NO_PARENT and size[v] > 0 and (best_child[p] == NO_PARENT or size[v] > size[best_child[p]])) {
+                best_child[p] = v;
+            }
+        }
+
+        uint64_t v = *std::ranges::max_element(order, {}, [&size](const uint64_t u) { return size[u]; });
+        // The bounds are exact on the whole tree, nothing left to improve from this root
+        if (size[v] <= 0) {
+            ++misses;
+            continue;
+        }
+        while (best_child[v] != NO_PARENT) {
+            v = best_child[v];
+        }
+        landmarks_.push_back(v);
+        is_landmark[v] = 1;
+        forward.push_back(distances_from(graph_, v));
+    }
+}
+
+void LandmarkIndex::compute_tables(const size_t threads, std::vector<std::vector<double>>& forward,
+                                   std::vector<std::vector<double>>& reverse) const {
+    // Jobs 0 .. k - 1 are forward tables, k .. 2k - 1 reverse tables; those already there are skipped
+    const size_t k = landmarks_.size();
+    const size_t computed = forward.size();
+    forward.resize(k);
+    if (directed_) reverse.resize(k);
+    const size_t jobs = directed_ ? 2 * k : k;
+    parallel::parallel_for(jobs - computed, threads, [&](const size_t begin, const size_t end, size_t) {
+        for (size_t job = computed + begin; job < computed + end; ++job) {
+            if (job < k) {
+                forward[job] = distances_from(graph_, landmarks_[job]);
+            } else {
+                reverse[job - k] = distances_from(*reverse_, landmarks_[job - k]);
+            }
+        }
+    });
+}
+
+void LandmarkIndex::store(const std::vector<std::vector<double>>& forward,
+                          const std::vector<std::vector<double>>& reverse) {
+    const size_t k = landmarks_.size();
+    auto transpose = [&](const std::vector<std::vector<double>>& tables, auto& out, auto encode) {
+        out.resize(n_ * k);
+        for (size_t v = 0; v < n_; ++v) {
+            for (size_t i = 0; i < k; ++i) {
+                out[v * k + i] = encode(tables[i][v]);
+            }
+        }
+    };
+
+    if (precision_ == LandmarkPrecision::Float32) {
+        const auto encode = [](const double d) { return static_cast<float>(d); };
+        transpose(forward, forward_f32_, encode);
+        if (directed_) transpose(reverse, reverse_f32_, encode);
+        return;
+    }
+
+    double max_dist = 0;
+    for (const auto* tables : {&forward, &reverse}) {
+        for (const auto& table : *tables) {
+            for (const double d : table) {
+                if (d != INF) max_dist = std::max(max_dist, d);
+            }
+        }
+    }
+    // Largest code is UINT32_MAX - 1, floor never rounds past it
+    scale_ = max_dist > 0 ? (static_cast<double>(U32_UNREACHABLE) - 1) / max_dist : 1;
+    const auto encode = [this](const double d) {
+        if (d == INF) return U32_UNREACHABLE;
+        return std::min(static_cast<uint32_t>(std::floor(d * scale_)), U32_UNREACHABLE - 1);
+    };
+    transpose(forward, forward_u32_, encode);
+    if (directed_) transpose(reverse, reverse_u32_, encode);
+}
+
+template <typename T>
+double LandmarkIndex::decode(const T value) const {
+    if constexpr (std::same_as<T, float>) {
+        return value;
+    } else {
+        return value == U32_UNREACHABLE ? INF : static_cast<double>(value) / scale_;
+    }
+}
+
+template <typename T>
+double LandmarkIndex::slack(const double a, const double b) const {
+    if constexpr (std::same_as<T, float>) {
+        // Rounding to float moves a value by at most half an ulp, 2^-24 relative; twice that covers the decode too
+        return (a + b) * 0x1p-23;
+    } else {
+        // floor(d * scale) / scale is below d by less than one step
+        return 1.0 / scale_;
+    }
+}
+
+template <typename T>
+void LandmarkIndex::target_row(const T* forward, const T* reverse, const uint64_t t, std::vector<double>& t_forward,
+                               std::vector<double>& t_reverse) const {
+    const size_t k = landmarks_.size();
+    t_forward.resize(k);
+    t_reverse.resize(k);
+    for (size_t i = 0; i < k; ++i) {
+        t_forward[i] = decode(forward[t * k + i]);
+        t_reverse[i] = decode(reverse[t * k + i]);
+    }
+}
+
+template <typename T>
+double LandmarkIndex::bound(const T* forward, const T* reverse, const uint64_t v, const std::vector<double>& t_forward,
+                            const std::vector<double>& t_reverse) const {
+    const size_t k = landmarks_.size();
+    const T* v_forward = forward + v * k;
+    const T* v_reverse = reverse + v * k;
+    double best = 0;
+    for (size_t i = 0; i < k; ++i) {
+        // d(L, t) - d(L, v): L reaches v, so if it does not reach t neither does v
+        const double lv = decode(v_forward[i]);
+        if (lv != INF) {
+            if (t_forward[i] == INF) return INF;
+            best = std::max(best, t_forward[i] - lv - slack<T>(t_forward[i], lv));
+        }
+        // d(v, L) - d(t, L): t reaches L, so if v does not reach L it does not reach t
+        if (t_reverse[i] != INF) {
+            const double vl = decode(v_reverse[i]);
+            if (vl == INF) return INF;
+            best = std::max(best, vl - t_reverse[i] - slack<T>(vl, t_reverse[i]));
+        }
+    }
+    return best;
+}
+
+template <typename T>
+PointQuery LandmarkIndex::astar(const T* forward, const T* reverse, const uint64_t s, const uint64_t t,
+                                SparseDistances& ws) const {
+    std::vector<double> t_forward, t_reverse;
+    target_row(forward, reverse, t, t_forward, t_reverse);
+    ws.clear();
+    PointQuery result;
+    const double h_s = bound(forward, reverse, s, t_forward, t_reverse);
+    if (h_s == INF) return result;
+
+    // Rounded bounds need not be consistent, a vertex may be scanned again after its distance drops. The first time
+    // t is popped its distance is exact all the same, the bounds never overestimate.
+    std::priority_queue<AStarEntry, std::vector<AStarEntry>, std::greater<>> pq;
+    ws.set(s, 0.0);
+    pq.push({h_s, 0.0, s});
+    while (!pq.empty()) {
+        const auto [f, g, u] = pq.top();
+        pq.pop();
+        if (g != ws.get(u)) continue;
+        ++result.settled;
+        if (u == t) {
+            result.dist = g;
+            return result;
+        }
+        for (const auto& [v, w] : graph_.neighbors(u)) {
+            const double cand = g + w;
+            if (cand >= ws.get(v)) continue;
+            ws.set(v, cand);
+            const double h = bound(forward, reverse, v, t_forward, t_reverse);
+            if (h != INF) pq.push({cand + h, cand, v});
+        }
+    }
+    return result;
+}
+
+template <typename R>
+PointQuery LandmarkIndex::bidirectional(const R& reverse, const uint64_t s, const uint64_t t,
+                                        SparseDistances& forward, SparseDistances& backward) const {
+    forward.clear();
+    backward.clear();
+    PointQuery result;
+    using Heap = std::priority_queue<Pair, std::vector<Pair>, std::greater<>>;
+    Heap pq_forward, pq_backward;
+    forward.set(s, 0.0);
+    backward.set(t, 0.0);
+    pq_forward.emplace(s, 0.0);
+    pq_backward.emplace(t, 0.0);
+    // Shortest s -> t path seen so far, through an arc scanned by either side
+    double best = s == t ? 0.0 : INF;
+
+    auto scan = [&](Heap& pq, SparseDistances& mine, const SparseDistances& other, const auto& adjacency) {
+        const auto [u, dist_u] = pq.top();
+        pq.pop();
+        if (dist_u != mine.get(u)) return;
+        ++result.settled;
+        for (const auto& [v, w] : adjacency.neighbors(u)) {
+            const double cand = dist_u + w;
+            if (cand < mine.get(v)) {
+                mine.set(v, cand);
+                pq.emplace(v, cand);
+            }
+            best = std::min(best, cand + other.get(v));
+        }
+    };
+
+    // Stop once the two frontiers together cannot beat the best path, every shorter one would have been seen
+    while (!pq_forward.empty() and !pq_backward.empty()
+           and pq_forward.top().value_ + pq_backward.top().value_ < best) {
+        if (pq_forward.top().value_ <= pq_backward.top().value_) {
+            scan(pq_forward, forward, backward, graph_);
+        } else {
+            scan(pq_backward, backward, forward, reverse);
+        }
+    }
+    result.dist = best;
+    return result;
+}
+
+double LandmarkIndex::lower_bound(const uint64_t v, const uint64_t t) const {
+    auto run = [&](const auto& forward, const auto& reverse) {
+        const auto* f = forward.data();
+        const auto* r = directed_ ? reverse.data() : f;
+        std::vector<double> t_forward, t_reverse;
+        target_row(f, r, t, t_forward, t_reverse);
+        return bound(f, r, v, t_forward, t_reverse);
+    };
+    if (landmarks_.empty()) return 0;
+    return precision_ == LandmarkPrecision::Float32 ? run(forward_f32_, reverse_f32_)
+                                                    : run(forward_u32_, reverse_u32_);
+}
+
+PointQuery LandmarkIndex::query(const uint64_t s, const uint64_t t, SparseDistances& ws) const {
+    auto run = [&](const auto& forward, const auto& reverse) {
+        const auto* f = forward.data();
+        return astar(f, directed_ ? reverse.data() : f, s, t, ws);
+    };
+    return precision_ == LandmarkPrecision::Float32 ? run(forward_f32_, reverse_f32_)
+                                                    : run(forward_u32_, reverse_u32_);
+}
+
+PointQuery LandmarkIndex::bidirectional_dijkstra(const uint64_t s, const uint64_t t, SparseDistances& forward,
+                                                 SparseDistances& backward) const {
+    if (reverse_) return bidirectional(*reverse_, s, t, forward, backward);
+    return bidirectional(graph_, s, t, forward, backward);
+}
@@ -0,0 +1,125 @@
+#ifndef ALGO_SEMINAR_LANDMARK_INDEX_H
+#define ALGO_SEMINAR_LANDMARK_INDEX_H
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "CSRGraph.h"
+#include "Graph.h"
+#include "SparseDistances.h"
+
+/*
+How landmarks are picked:
+    - Farthest: each new landmark is the vertex farthest from the ones already chosen, the first one the vertex
+      farthest from a random start.
+    - Avoid (Goldberg & Werneck): grow a shortest-path tree from a random root, weigh every vertex by how much the
+      current landmarks underestimate its distance from the root, and descend from the heaviest subtree without a
+      landmark to one of its leaves. Lands in regions the current bounds cover badly.
+*/
+enum class LandmarkStrategy {Farthest, Avoid};
+
+// Float32 keeps ~7 significant digits, UInt32 fixed point with the step max distance / 2^32. Either is 4 bytes.
+enum class LandmarkPrecision {Float32, UInt32};
+
+// Result of an s -> t query
+struct PointQuery {
+    double dist = std::numeric_limits<double>::infinity();
+    size_t settled = 0;  // heap pops that scanned a vertex, both directions for bidirectional search
+};
+
+/*
+ALT: A* search with lower bounds from landmark distances and the triangle inequality,
+    d(v, t) >= d(L, t) - d(L, v)    and    d(v, t) >= d(v, L) - d(t, L)
+for every landmark L. The tables hold d(L, v) for all landmarks and vertices and, on directed graphs, d(v, L) from
+runs on the reversed graph; they are vertex major so that the bounds of one vertex share a cache line. Stored values
+are rounded, every bound is lowered by the largest possible rounding error to stay a lower bound.
+Tables are computed with BasicDijkstra. Selection needs the table of each landmark before it picks the next one, so
+the forward tables of selected landmarks are computed one after another; reverse tables, and all tables of a given
+landmark set, are computed on up to `threads` threads. Queries are const and use caller-owned workspaces, one index
+serves any number of threads.
+*/
+class LandmarkIndex {
+    const Graph& graph_;
+    size_t n_;
+    bool directed_;
+    // Arcs into every vertex, directed graphs only
+    std::optional<CSRGraph> reverse_;
+
+    LandmarkPrecision precision_;
+    std::vector<uint64_t> landmarks_;
+    // [v * landmarks + i] is d(L_i, v), and d(v, L_i) in the reverse table
+    std::vector<float> forward_f32_, reverse_f32_;
+    std::vector<uint32_t> forward_u32_, reverse_u32_;
+    // UInt32 stores floor(d * scale_), UINT32_MAX is unreachable
+    double scale_ = 1;
+    double build_ms_ = 0;
+
+    void select(size_t count, LandmarkStrategy strategy, uint64_t seed, std::vector<std::vector<double>>& forward);
+
+    // Tables of landmarks_[i] for i >= forward.size(), and all reverse tables, on up to `threads` threads
+    void compute_tables(size_t threads, std::vector<std::vector<double>>& forward,
+                        std::vector<std::vector<double>>& reverse) const;
+
+    void store(const std::vector<std::vector<double>>& forward, const std::vector<std::vector<double>>& reverse);
+
+    template <typename T>
+    [[nodiscard]] double decode(T value) const;
+
+    // Largest possible error of a - b for two decoded values
+    template <typename T>
+    [[nodiscard]] double slack(double a, double b) const;
+
+    // The row of t decoded, the target side of every bound of a query
+    template <typename T>
+    void target_row(const T* forward, const T* reverse, uint64_t t, std::vector<double>& t_forward,
+                    std::vector<double>& t_reverse) const;
+
+    template <typename T>
+    [[nodiscard]] double bound(const T* forward, const T* reverse, uint64_t v, const std::vector<double>& t_forward,
+                               const std::vector<double>& t_reverse) const;
+
+    template <typename T>
+    PointQuery astar(const T* forward, const T* reverse, uint64_t s, uint64_t t, SparseDistances& ws) const;
+
+    template <typename R>
+    PointQuery bidirectional(const R& reverse, uint64_t s, uint64_t t, SparseDistances& forward,
+                             SparseDistances& backward) const;
+
+public:
+    LandmarkIndex(const Graph& graph, size_t landmarks, LandmarkStrategy strategy = LandmarkStrategy::Avoid,
+                  LandmarkPrecision precision = LandmarkPrecision::Float32, size_t threads = 1, uint64_t seed = 42);
+
+    // Tables for a given landmark set, all of them computed in parallel
+    LandmarkIndex(const Graph& graph, std::vector<uint64_t> landmarks,
+                  LandmarkPrecision precision = LandmarkPrecision::Float32, size_t threads = 1);
+
+    // Lower bound on d(v, t), infinity if the tables prove t unreachable from v
+    [[nodiscard]] double lower_bound(uint64_t v, uint64_t t) const;
+
+    // Landmark A* from s to t, ws needs size n
+    PointQuery query(uint64_t s, uint64_t t, SparseDistances& ws) const;
+
+    // Bidirectional Dijkstra without landmarks, the baseline for query
+    PointQuery bidirectional_dijkstra(uint64_t s, uint64_t t, SparseDistances& forward,
+                                      SparseDistances& backward) const;
+
+    [[nodiscard]] const std::vector<uint64_t>& landmarks() const {
+        return landmarks_;
+    }
+
+    // Bytes of the distance tables
+    [[nodiscard]] size_t bytes() const {
+        return (forward_f32_.size() + reverse_f32_.size()) * sizeof(float)
+             + (forward_u32_.size() + reverse_u32_.size()) * sizeof(uint32_t);
+    }
+
+    // Wall clock of selection and table computation
+    [[nodiscard]] double build_ms() const {
+        return build_ms_;
+    }
+};
+
+
+#endif //ALGO_SEMINAR_LANDMARK_INDEX_H
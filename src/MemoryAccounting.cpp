@@ -0,0 +1,225 @@
+#include "MemoryAccounting.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace memory {
+
+namespace {
+
+struct Counter {
+    std::atomic<int64_t> current{0};
+    std::atomic<int64_t> peak{0};
+    std::atomic<uint64_t> allocations{0};
+};
+
+// One per subsystem and the total last. Constant-initialized, so allocations made during static initialization of
+// other translation units already find them.
+constinit std::array<Counter, SUBSYSTEMS + 1> counters;
+constinit thread_local Subsystem current_subsystem = Subsystem::Other;
+
+void charge(const Subsystem subsystem, const int64_t bytes) {
+    for (Counter* c : {&counters[static_cast<size_t>(subsystem)], &counters[SUBSYSTEMS]}) {
+        const int64_t now = c->current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        if (bytes < 0) continue;
+        c->allocations.fetch_add(1, std::memory_order_relaxed);
+        int64_t seen = c->peak.load(std::memory_order_relaxed);
+        while (now > seen and !c->peak.compare_exchange_weak(seen, now, std::memory_order_relaxed)) {}
+    }
+}
+
+Usage snapshot(const Counter& c) {
+    return {c.current.load(std::memory_order_relaxed), c.peak.load(std::memory_order_relaxed),
+            c.allocations.load(std::memory_order_relaxed)};
+}
+
+}
+
+const char* subsystem_name(const Subsystem subsystem) {
+    switch (subsystem) {
+        case Subsystem::Other: return "other";
+        case Subsystem::Graph: return "graph";
+        case Subsystem::Engine: return "engine";
+        case Subsystem::DequeueBlocks: return "dequeue_blocks";
+        case Subsystem::FibHeap: return "fib_heap";
+        case Subsystem::Frames: return "frames";
+    }
+    return "?";
+}
+
+bool accounting_enabled() {
+    return MEMORY_ACCOUNTING;
+}
+
+std::array<Usage, SUBSYSTEMS> usage() {
+    std::array<Usage, SUBSYSTEMS> result;
+    for (size_t s = 0; s < SUBSYSTEMS; ++s) result[s] = snapshot(counters[s]);
+    return result;
+}
+
+Usage total() {
+    return snapshot(counters[SUBSYSTEMS]);
+}
+
+void reset_peaks() {
+    for (Counter& c : counters) {
+        c.peak.store(c.current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        c.allocations.store(0, std::memory_order_relaxed);
+    }
+}
+
+Subsystem charge_external(const int64_t bytes) {
+    if (MEMORY_ACCOUNTING) charge(current_subsystem, bytes);
+    return current_subsystem;
+}
+
+void release_external(const Subsystem subsystem, const int64_t bytes) {
+    if (MEMORY_ACCOUNTING) charge(subsystem, -bytes);
+}
+
+Scope::Scope(const Subsystem subsystem) : previous_(current_subsystem) {
+    current_subsystem = subsystem;
+}
+
+Scope::~Scope() {
+    current_subsystem = previous_;
+}
+
+#if MEMORY_ACCOUNTING
+
+namespace {
+
+// Sits right in front of every block handed out; offset leads back to what malloc returned
+struct alignas(16) Header {
+    uint64_t size;
+    uint32_t offset;
+    Subsystem subsystem;
+};
+
+static_assert(sizeof(Header) == alignof(std::max_align_t));
+
+void* allocate(const size_t size, const size_t alignment) {
+    // The gap in front of the block holds the header and keeps the block aligned
+    const size_t offset = std::max(alignment, sizeof(Header));
+    void* base = alignment <= alignof(std::max_align_t)
+                     ? std::malloc(size + offset)
+                     : std::aligned_alloc(alignment, (size + offset + alignment - 1) / alignment * alignment);
+    if (!base) return nullptr;
+    auto* block = static_cast<std::byte*>(base) + offset;
+    Header* header = reinterpret_cast<Header*>(block) - 1;
+    header->size = size;
+    header->offset = static_cast<uint32_t>(offset);
+    header->subsystem = current_subsystem;
+    charge(header->subsystem, static_cast<int64_t>(size));
+    return block;
+}
+
+void* allocate_or_throw(const size_t size, const size_t alignment) {
+    while (true) {
+        if (void* block = allocate(size, alignment)) return block;
+        const std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void deallocate(void* block) {
+    if (!block) return;
+    const Header* header = static_cast<Header*>(block) - 1;
+    charge(header->subsystem, -static_cast<int64_t>(header->size));
+    std::free(static_cast<std::byte*>(block) - header->offset);
+}
+
+}
+
+#endif
+
+}
+
+#if MEMORY_ACCOUNTING
+
+// Replacements of every global allocation function, the sized and nothrow forms included so that none of them reaches
+// the standard library's versions with a block that carries a header
+void* operator new(const size_t size) {
+    return memory::allocate_or_throw(size, alignof(std::max_align_t));
+}
+
+void* operator new[](const size_t size) {
+    return memory::allocate_or_throw(size, alignof(std::max_align_t));
+}
+
+void* operator new(const size_t size, const std::align_val_t alignment) {
+    return memory::allocate_or_throw(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](const size_t size, const std::align_val_t alignment) {
+    return memory::allocate_or_throw(size, static_cast<size_t>(alignment));
+}
+
+void* operator new(const size_t size, const std::nothrow_t&) noexcept {
+    return memory::allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new[](const size_t size, const std::nothrow_t&) noexcept {
+    return memory::allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(const size_t size, const std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return memory::allocate(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](const size_t size, const std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return memory::allocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* block) noexcept {
+    memory::deallocate(block);
+}
+
+void operator delete[](void* block) noexcept {
+    memory::deallocate(block);
+}
+
+void operator delete(void* block, size_t) noexcept {
+    memory::deallocate(block);
+}
+
+void operator delete[](void* block, size_t) noexcept {
+    memory::deallocate(block);
+}
+
+void operator delete(void* block, std::align_val_t) noexcept {
+    memory::deallocate(block);
+}
+
+void operator delete[](void* block, std::align_val_t) noexcept {
+    memory::deallocate(block);
+}
+
+void operator delete(void* block, size_t, std::align_val_t) noexcept {
+    memory::deallocate(block);
+}
+
+void operator delete[](void* block, size_t, std::align_val_t) noexcept {
+    memory::deallocate(block);
+}
+
+void operator delete(void* block, const std::nothrow_t&) noexcept {
+    memory::deallocate(block);
+}
+
+void operator delete[](void* block, const std::nothrow_t&) noexcept {
+    memory::deallocate(block);
+}
+
+void operator delete(void* block, std::align_val_t, const std::nothrow_t&) noexcept {
+    memory::deallocate(block);
+}
+
+void operator delete[](void* block, std::align_val_t, const std::nothrow_t&) noexcept {
+    memory::deallocate(block);
+}
+
+#endif
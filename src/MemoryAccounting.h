@@ -0,0 +1,80 @@
+#ifndef ALGO_SEMINAR_MEMORY_ACCOUNTING_H
+#define ALGO_SEMINAR_MEMORY_ACCOUNTING_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/*
+Heap bytes per subsystem, current and peak. MEMORY_SCOPE(Subsystem) at the top of a block charges every allocation the
+calling thread makes inside it to that subsystem; scopes nest and the innermost wins, allocations outside any scope
+count as Other. The hooks are replacements of the global operator new and delete, which put a 16-byte header in front
+of every block to remember its size and subsystem, so memory is credited back to the right subsystem wherever it is
+freed. Worker threads of parallel_for start outside any scope. The header and the atomic updates cost on every
+allocation, so all of it only exists when MEMORY_ACCOUNTING is defined to 1 (CMake option MEMORY_ACCOUNTING);
+otherwise MEMORY_SCOPE expands to nothing, the standard operator new is used and usage() stays zero.
+*/
+#ifndef MEMORY_ACCOUNTING
+#define MEMORY_ACCOUNTING 0
+#endif
+
+#if MEMORY_ACCOUNTING
+#define MEMORY_SCOPE(subsystem) const memory::Scope memory_scope(memory::Subsystem::subsystem)
+#else
+#define MEMORY_SCOPE(subsystem)
+#endif
+
+namespace memory {
+
+enum class Subsystem : uint8_t {
+    Other,
+    Graph,  // Graph vertices and arcs, CSRGraph arrays
+    Engine,  // per-vertex arrays, buffers and results of BMSSP and Dijkstra
+    DequeueBlocks,  // blocks, maps and key indices of the BMSSP queues
+    FibHeap,  // heap nodes and consolidation tables
+    Frames,  // recorded visualisation frames
+};
+
+inline constexpr size_t SUBSYSTEMS = 6;
+
+const char* subsystem_name(Subsystem subsystem);
+
+struct Usage {
+    int64_t current = 0;  // bytes allocated and not yet freed
+    int64_t peak = 0;  // highest current since the last reset_peaks
+    uint64_t allocations = 0;
+};
+
+// Always false unless built with MEMORY_ACCOUNTING
+bool accounting_enabled();
+
+// Usage of every subsystem, indexed by Subsystem, over all threads
+std::array<Usage, SUBSYSTEMS> usage();
+
+// All subsystems together; its peak is the peak of the sum, not the sum of the peaks
+Usage total();
+
+// Peaks (and allocation counts) restart from the current bytes, to measure one phase or engine run
+void reset_peaks();
+
+// Memory that bypasses operator new, the mmap'ed blocks of PageAllocator. The bytes are charged to the innermost scope,
+// which is returned so that release_external credits them back to the same subsystem. Both do nothing unless built
+// with MEMORY_ACCOUNTING.
+Subsystem charge_external(int64_t bytes);
+void release_external(Subsystem subsystem, int64_t bytes);
+
+class Scope {
+    Subsystem previous_;
+
+public:
+    explicit Scope(Subsystem subsystem);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+};
+
+}
+
+
+#endif //ALGO_SEMINAR_MEMORY_ACCOUNTING_H
@@ -0,0 +1,86 @@
+#ifndef ALGO_SEMINAR_MIN_PLUS_KERNELS_H
+#define ALGO_SEMINAR_MIN_PLUS_KERNELS_H
+
+#include <cstddef>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/*
+Min-plus relaxation of one arc for L sources at once: to[i] = min(to[i], from[i] + w) for every lane i, L a multiple
+of 8. Returns whether any lane got lower. The AVX-512 and AVX2 paths are chosen at compile time (-march=native), the
+scalar path is always available.
+*/
+namespace min_plus {
+
+template <size_t L>
+bool relax_scalar(const double* from, const double w, double* to) {
+    bool lowered = false;
+    for (size_t i = 0; i < L; ++i) {
+        const double cand = from[i] + w;
+        if (cand < to[i]) {
+            to[i] = cand;
+            lowered = true;
+        }
+    }
+    return lowered;
+}
+
+#if defined(__AVX2__)
+template <size_t L>
+bool relax_avx2(const double* from, const double w, double* to) {
+    const __m256d wv = _mm256_set1_pd(w);
+    int lowered = 0;
+    for (size_t i = 0; i < L; i += 4) {
+        const __m256d cand = _mm256_add_pd(_mm256_loadu_pd(from + i), wv);
+        const __m256d cur = _mm256_loadu_pd(to + i);
+        lowered |= _mm256_movemask_pd(_mm256_cmp_pd(cand, cur, _CMP_LT_OQ));
+        _mm256_storeu_pd(to + i, _mm256_min_pd(cand, cur));
+    }
+    return lowered != 0;
+}
+#endif
+
+#if defined(__AVX512F__)
+template <size_t L>
+bool relax_avx512(const double* from, const double w, double* to) {
+    const __m512d wv = _mm512_set1_pd(w);
+    __mmask8 lowered = 0;
+    for (size_t i = 0; i < L; i += 8) {
+        const __m512d cand = _mm512_add_pd(_mm512_loadu_pd(from + i), wv);
+        const __m512d cur = _mm512_loadu_pd(to + i);
+        const __mmask8 lt = _mm512_cmp_pd_mask(cand, cur, _CMP_LT_OQ);
+        // Lanes that did not get lower are left alone, no store at all for most arcs
+        _mm512_mask_storeu_pd(to + i, lt, cand);
+        lowered |= lt;
+    }
+    return lowered != 0;
+}
+#endif
+
+template <size_t L>
+bool relax(const double* from, const double w, double* to) {
+    static_assert(L % 8 == 0, "lanes come in multiples of 8");
+#if defined(__AVX512F__)
+    return relax_avx512<L>(from, w, to);
+#elif defined(__AVX2__)
+    return relax_avx2<L>(from, w, to);
+#else
+    return relax_scalar<L>(from, w, to);
+#endif
+}
+
+inline const char* isa_name() {
+#if defined(__AVX512F__)
+    return "avx512";
+#elif defined(__AVX2__)
+    return "avx2";
+#else
+    return "scalar";
+#endif
+}
+
+}
+
+#endif //ALGO_SEMINAR_MIN_PLUS_KERNELS_H
@@ -0,0 +1,110 @@
+#include "MultiSourceSSSP.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "CSRGraph.h"
+#include "GridGraph.h"
+#include "MinPlusKernels.h"
+#include "MutableGraph.h"
+#include "Parallel.h"
+#include "RelaxKernels.h"
+
+static constexpr double INF = std::numeric_limits<double>::infinity();
+
+template <SSSPGraph G, size_t Lanes>
+MultiSourceSSSP<G, Lanes>::MultiSourceSSSP(const G& graph) : graph_(graph), n_(graph.size()), queued_(n_, 0) {}
+
+template <SSSPGraph G, size_t Lanes>
+void MultiSourceSSSP<G, Lanes>::run(const std::span<const uint64_t> sources) {
+    sources_ = std::min(sources.size(), Lanes);
+    stats_ = {};
+    dist_.assign(n_ * Lanes, INF);
+    std::ranges::fill(queued_, 0);
+
+    frontier_.clear();
+    for (size_t i = 0; i < sources_; ++i) {
+        const uint64_t src = sources[i];
+        dist_[src * Lanes + i] = 0.0;
+        // Two lanes may start at the same vertex, scan it once
+        if (queued_[src] == 0) {
+            queued_[src] = 1;
+            frontier_.push_back(src);
+        }
+    }
+
+    while (!frontier_.empty()) {
+        ++stats_.rounds;
+        const uint64_t mark = stats_.rounds + 1;
+        next_.clear();
+        for (const uint64_t u : frontier_) {
+            ++stats_.scans;
+            const double* from = dist_.data() + u * Lanes;
+            // A row of Lanes distances is one cache line per 8 lanes
+            const auto fetch = [&](const uint64_t v) {
+                for (size_t i = 0; i < Lanes; i += 8) relax_kernels::prefetch(dist_.data() + v * Lanes + i);
+            };
+            relax_kernels::for_each_prefetched(graph_.neighbors(u), fetch, [&](const uint64_t v, const double w) {
+                ++stats_.relaxations;
+                if (min_plus::relax<Lanes>(from, w, dist_.data() + v * Lanes) and queued_[v] != mark) {
+                    queued_[v] = mark;
+                    next_.push_back(v);
+                }
+            });
+        }
+        std::swap(frontier_, next_);
+    }
+}
+
+template <SSSPGraph G, size_t Lanes>
+std::vector<double> MultiSourceSSSP<G, Lanes>::distances(const size_t lane) const {
+    std::vector<double> result(n_);
+    for (size_t v = 0; v < n_; ++v) {
+        result[v] = dist_[v * Lanes + lane];
+    }
+    return result;
+}
+
+template <SSSPGraph G, size_t Lanes>
+std::vector<std::vector<double>> multi_source_distances(const G& graph, const std::span<const uint64_t> sources,
+                                                        const size_t threads) {
+    std::vector<std::vector<double>> result(sources.size());
+    const size_t batches = (sources.size() + Lanes - 1) / Lanes;
+    parallel::parallel_for(batches, threads, [&](const size_t begin, const size_t end, size_t) {
+        MultiSourceSSSP<G, Lanes> engine(graph);
+        for (size_t b = begin; b < end; ++b) {
+            const auto batch = sources.subspan(b * Lanes, std::min(Lanes, sources.size() - b * Lanes));
+            engine.run(batch);
+            for (size_t i = 0; i < batch.size(); ++i) {
+                result[b * Lanes + i] = engine.distances(i);
+            }
+        }
+    });
+    return result;
+}
+
+template class MultiSourceSSSP<Graph, 8>;
+template class MultiSourceSSSP<Graph, 16>;
+template class MultiSourceSSSP<CSRGraph, 8>;
+template class MultiSourceSSSP<CSRGraph, 16>;
+template class MultiSourceSSSP<GridGraph, 8>;
+template class MultiSourceSSSP<GridGraph, 16>;
+template class MultiSourceSSSP<GraphSnapshot, 8>;
+template class MultiSourceSSSP<GraphSnapshot, 16>;
+
+template std::vector<std::vector<double>> multi_source_distances<Graph, 8>(const Graph&, std::span<const uint64_t>,
+                                                                           size_t);
+template std::vector<std::vector<double>> multi_source_distances<Graph, 16>(const Graph&, std::span<const uint64_t>,
+                                                                            size_t);
+template std::vector<std::vector<double>> multi_source_distances<CSRGraph, 8>(const CSRGraph&,
+                                                                              std::span<const uint64_t>, size_t);
+template std::vector<std::vector<double>> multi_source_distances<CSRGraph, 16>(const CSRGraph&,
+                                                                               std::span<const uint64_t>, size_t);
+template std::vector<std::vector<double>> multi_source_distances<GridGraph, 8>(const GridGraph&,
+                                                                               std::span<const uint64_t>, size_t);
+template std::vector<std::vector<double>> multi_source_distances<GridGraph, 16>(const GridGraph&,
+                                                                                std::span<const uint64_t>, size_t);
+template std::vector<std::vector<double>> multi_source_distances<GraphSnapshot, 8>(const GraphSnapshot&,
+                                                                                   std::span<const uint64_t>, size_t);
+template std::vector<std::vector<double>> multi_source_distances<GraphSnapshot, 16>(const GraphSnapshot&,
+                                                                                    std::span<const uint64_t>, size_t);
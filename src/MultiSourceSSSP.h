@@ -0,0 +1,65 @@
+#ifndef ALGO_SEMINAR_MULTI_SOURCE_SSSP_H
+#define ALGO_SEMINAR_MULTI_SOURCE_SSSP_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "PageAllocator.h"
+#include "SSSPGraph.h"
+
+struct MultiSourceStats {
+    uint64_t rounds = 0;
+    uint64_t scans = 0;  // vertices scanned, a vertex is scanned once per round it is active in
+    uint64_t relaxations = 0;  // arcs relaxed, each for all lanes at once
+};
+
+/*
+Distances from up to Lanes sources in one label-correcting pass. Every vertex holds Lanes distances side by side and an
+arc is relaxed for all of them with one min-plus kernel call (MinPlusKernels.h), so each adjacency list is read once
+per round for all sources instead of once per source. A round scans the vertices that got lower in any lane in the
+previous one, in the order they got lower; lower values are visible within the round already. It ends when no lane
+changes.
+Lanes is 8 or 16. The definitions live in MultiSourceSSSP.cpp and are instantiated there for the SSSPGraph backends.
+*/
+template <SSSPGraph G, size_t Lanes = 8>
+class MultiSourceSSSP {
+    const G& graph_;
+    size_t n_;
+    size_t sources_ = 0;
+    // dist_[v * Lanes + i] is the distance of v from the i-th source
+    PageVector<double> dist_;
+    std::vector<uint64_t> frontier_, next_;
+    // queued_[v] is the round v was last put in next_ in, plus one
+    PageVector<uint64_t> queued_;
+    MultiSourceStats stats_;
+
+public:
+    explicit MultiSourceSSSP(const G& graph);
+
+    // Distances from at most Lanes sources, replaces the previous run
+    void run(std::span<const uint64_t> sources);
+
+    [[nodiscard]] double distance(const size_t lane, const uint64_t v) const {
+        return dist_[v * Lanes + lane];
+    }
+
+    // Distances of every vertex from the lane-th source, the vector std_heap_run returns
+    [[nodiscard]] std::vector<double> distances(size_t lane) const;
+
+    [[nodiscard]] size_t sources() const {
+        return sources_;
+    }
+
+    [[nodiscard]] const MultiSourceStats& stats() const {
+        return stats_;
+    }
+};
+
+// Distance vectors of all sources, Lanes at a time on up to `threads` threads; result[i] belongs to sources[i]
+template <SSSPGraph G, size_t Lanes = 8>
+std::vector<std::vector<double>> multi_source_distances(const G& graph, std::span<const uint64_t> sources,
+                                                        size_t threads = 1);
+
+
+#endif //ALGO_SEMINAR_MULTI_SOURCE_SSSP_H
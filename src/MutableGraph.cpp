@@ -0,0 +1,153 @@
+#include "MutableGraph.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+MutableGraph::MutableGraph(const Graph& graph, const size_t compact_threshold, const bool background)
+    : compact_threshold_(compact_threshold != 0 ? compact_threshold : std::max<size_t>(1024, graph.size() / 32)) {
+    auto snapshot = std::make_shared<GraphSnapshot>();
+    snapshot->base_ = std::make_shared<const CSRGraph>(graph);
+    // Enough levels for the largest vertex id
+    for (uint64_t rest = graph.size() > 1 ? (graph.size() - 1) >> GraphSnapshot::OVERLAY_BITS : 0; rest != 0;
+         rest >>= GraphSnapshot::OVERLAY_BITS) {
+        ++snapshot->overlay_levels_;
+    }
+    current_.store(std::move(snapshot));
+    if (background) {
+        compactor_ = std::jthread([this](const std::stop_token& stop) { compactor_loop(stop); });
+    }
+}
+
+void GraphSnapshot::set_list(const uint64_t v, List list) {
+    const auto copy = [](const OverlayNode* node, const bool last) {
+        if (node) return std::make_shared<OverlayNode>(*node);
+        auto fresh = std::make_shared<OverlayNode>();
+        if (last) fresh->slots.emplace<OverlayNode::Lists>();
+        return fresh;
+    };
+    auto root = copy(overlay_.get(), overlay_levels_ == 1);
+    OverlayNode* node = root.get();
+    for (unsigned level = 0; level + 1 < overlay_levels_; ++level) {
+        auto& child = std::get<OverlayNode::Children>(node->slots)[slot(v, level)];
+        auto next = copy(child.get(), level + 2 == overlay_levels_);
+        node = next.get();
+        child = std::move(next);
+    }
+    auto& target = std::get<OverlayNode::Lists>(node->slots)[slot(v, overlay_levels_ - 1)];
+    if (!target) ++overlay_size_;
+    target = std::move(list);
+    overlay_ = std::move(root);
+}
+
+void GraphSnapshot::changed_lists(const GraphSnapshot& since, std::vector<std::pair<uint64_t, List>>& changed) const {
+    // Both snapshots come from the same MutableGraph, so their tries have the same depth
+    const auto walk = [&](const auto& self, const OverlayNode* node, const OverlayNode* old, const unsigned level,
+                          const uint64_t prefix) -> void {
+        if (!node or node == old) return;
+        if (level + 1 == overlay_levels_) {
+            const auto& lists = std::get<OverlayNode::Lists>(node->slots);
+            for (size_t i = 0; i < OVERLAY_FANOUT; ++i) {
+                const bool shared = old and std::get<OverlayNode::Lists>(old->slots)[i] == lists[i];
+                if (lists[i] and !shared) changed.emplace_back(prefix << OVERLAY_BITS | i, lists[i]);
+            }
+            return;
+        }
+        const auto& children = std::get<OverlayNode::Children>(node->slots);
+        for (size_t i = 0; i < OVERLAY_FANOUT; ++i) {
+            const OverlayNode* old_child = old ? std::get<OverlayNode::Children>(old->slots)[i].get() : nullptr;
+            self(self, children[i].get(), old_child, level + 1, prefix << OVERLAY_BITS | i);
+        }
+    };
+    walk(walk, overlay_.get(), since.overlay_.get(), 0, 0);
+}
+
+uint64_t MutableGraph::apply(const std::vector<EdgeOp>& ops) {
+    std::unique_lock lock(write_mutex_);
+    const auto current = current_.load(std::memory_order_acquire);
+    const size_t n = current->size();
+    for (const EdgeOp& op : ops) {
+        if (op.from >= n or op.to >= n) throw std::out_of_range("EdgeOp names a vertex outside the graph");
+    }
+    auto next = std::make_shared<GraphSnapshot>(*current);
+    next->version_ = current->version_ + 1;
+
+    // Adjacency lists copied in this batch, each mutated vertex is copied once per batch
+    std::unordered_map<uint64_t, std::shared_ptr<std::vector<Edge>>> copied;
+    for (const auto& [type, from, to, weight] : ops) {
+        auto [it, fresh] = copied.try_emplace(from, nullptr);
+        if (fresh) {
+            const auto adjacency = current->neighbors(from);
+            it->second = std::make_shared<std::vector<Edge>>(adjacency.begin(), adjacency.end());
+        }
+        auto& edges = *it->second;
+        switch (type) {
+            case EdgeOpType::Insert:
+                edges.emplace_back(to, weight);
+                break;
+            case EdgeOpType::Delete:
+                std::erase_if(edges, [to](const Edge& e) { return e.to_id_ == to; });
+                break;
+            case EdgeOpType::SetWeight:
+                for (auto& e : edges) {
+                    if (e.to_id_ == to) e.weight_ = weight;
+                }
+                break;
+        }
+    }
+
+    for (auto& [v, list] : copied) next->set_list(v, std::move(list));
+
+    const uint64_t version = next->version_;
+    const bool compact = next->overlay_size_ > compact_threshold_;
+    current_.store(std::move(next), std::memory_order_release);
+    lock.unlock();
+    if (compact) compact_cv_.notify_one();
+    return version;
+}
+
+void MutableGraph::compact() {
+    std::lock_guard compacting(compact_mutex_);
+    const auto source = current_.load(std::memory_order_acquire);
+    if (source->overlay_size_ == 0) return;
+
+    // Merging reads only the immutable source snapshot, writers keep going meanwhile
+    const size_t n = source->size();
+    PageVector<size_t> offsets(n + 1, 0);
+    for (uint64_t v = 0; v < n; ++v) {
+        offsets[v + 1] = offsets[v] + source->neighbors(v).size();
+    }
+    PageVector<Edge> edges;
+    edges.reserve(offsets.back());
+    for (uint64_t v = 0; v < n; ++v) {
+        const auto adjacency = source->neighbors(v);
+        edges.insert(edges.end(), adjacency.begin(), adjacency.end());
+    }
+    auto base = std::make_shared<const CSRGraph>(std::move(offsets), std::move(edges));
+
+    std::lock_guard lock(write_mutex_);
+    const auto current = current_.load(std::memory_order_acquire);
+    auto next = std::make_shared<GraphSnapshot>();
+    next->base_ = std::move(base);
+    next->overlay_levels_ = current->overlay_levels_;
+    next->version_ = current->version_;
+    // Lists replaced after the source snapshot was taken are not in the new base yet
+    std::vector<std::pair<uint64_t, GraphSnapshot::List>> changed;
+    current->changed_lists(*source, changed);
+    for (auto& [v, list] : changed) next->set_list(v, std::move(list));
+    current_.store(std::move(next), std::memory_order_release);
+    compactions_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MutableGraph::compactor_loop(const std::stop_token& stop) {
+    while (true) {
+        {
+            std::unique_lock lock(write_mutex_);
+            const bool due = compact_cv_.wait(lock, stop, [this] {
+                return current_.load(std::memory_order_acquire)->overlay_size() > compact_threshold_;
+            });
+            if (!due) return;
+        }
+        compact();
+    }
+}
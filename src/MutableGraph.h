@@ -0,0 +1,143 @@
+#ifndef ALGO_SEMINAR_MUTABLE_GRAPH_H
+#define ALGO_SEMINAR_MUTABLE_GRAPH_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "CSRGraph.h"
+#include "Graph.h"
+
+enum class EdgeOpType {Insert, Delete, SetWeight};
+
+// One arc mutation. Delete and SetWeight apply to every arc from -> to, Insert adds a parallel arc if one exists.
+// Undirected graphs are stored as two arcs per edge, mutate both.
+struct EdgeOp {
+    EdgeOpType type;
+    uint64_t from;
+    uint64_t to;
+    double weight = 0;
+};
+
+/*
+Immutable view of a MutableGraph: a CSR base plus an overlay holding the complete adjacency of every vertex mutated
+since the base was built. Snapshots are shared, a query keeps its snapshot alive for as long as it runs and never
+sees a later mutation.
+The overlay is a persistent radix trie over the vertex ids, OVERLAY_FANOUT children per node and the adjacency lists
+on the last level. A new snapshot shares every subtree of the previous one except the paths to the vertices it
+changes, so publishing costs O(touched vertices * depth) whatever the size of the overlay.
+*/
+class GraphSnapshot {
+    friend class MutableGraph;
+
+public:
+    static constexpr unsigned OVERLAY_BITS = 4;
+    static constexpr size_t OVERLAY_FANOUT = size_t{1} << OVERLAY_BITS;
+
+private:
+    using List = std::shared_ptr<const std::vector<Edge>>;
+
+    struct OverlayNode {
+        using Children = std::array<std::shared_ptr<const OverlayNode>, OVERLAY_FANOUT>;
+        using Lists = std::array<List, OVERLAY_FANOUT>;
+        // Children above the last level, lists on it
+        std::variant<Children, Lists> slots;
+    };
+
+    std::shared_ptr<const CSRGraph> base_;
+    std::shared_ptr<const OverlayNode> overlay_;
+    size_t overlay_size_ = 0;
+    unsigned overlay_levels_ = 1;
+    uint64_t version_ = 0;
+
+    [[nodiscard]] size_t slot(const uint64_t v, const unsigned level) const {
+        return (v >> (OVERLAY_BITS * (overlay_levels_ - 1 - level))) & (OVERLAY_FANOUT - 1);
+    }
+
+    [[nodiscard]] const std::vector<Edge>* overlay_find(const uint64_t v) const {
+        const OverlayNode* node = overlay_.get();
+        for (unsigned level = 0; node and level + 1 < overlay_levels_; ++level) {
+            node = std::get<OverlayNode::Children>(node->slots)[slot(v, level)].get();
+        }
+        return node ? std::get<OverlayNode::Lists>(node->slots)[slot(v, overlay_levels_ - 1)].get() : nullptr;
+    }
+
+    // Replaces the adjacency of v, copying the nodes on its path
+    void set_list(uint64_t v, List list);
+    // Lists of this snapshot that since does not share, subtrees both share are skipped
+    void changed_lists(const GraphSnapshot& since, std::vector<std::pair<uint64_t, List>>& changed) const;
+
+public:
+    [[nodiscard]] size_t size() const {
+        return base_->size();
+    }
+
+    [[nodiscard]] std::span<const Edge> neighbors(const uint64_t v) const {
+        if (overlay_size_ != 0) {
+            if (const auto* list = overlay_find(v)) return *list;
+        }
+        return base_->neighbors(v);
+    }
+
+    // Vertices whose adjacency lives in the overlay
+    [[nodiscard]] size_t overlay_size() const {
+        return overlay_size_;
+    }
+
+    // Number of mutation batches applied, compaction does not change it
+    [[nodiscard]] uint64_t version() const {
+        return version_;
+    }
+};
+
+/*
+Graph under a stream of edge mutations with snapshot isolation. Writers are serialised and publish a new snapshot per
+batch, copying only the adjacency of the vertices they touch and their overlay paths. Readers take the current
+snapshot with one atomic load and never wait for writers. Once the overlay covers more than compact_threshold vertices
+a background thread merges it into a fresh CSR base; mutations published in the meantime are carried over.
+The vertex set is fixed at construction.
+*/
+class MutableGraph {
+    std::atomic<std::shared_ptr<const GraphSnapshot>> current_;
+    std::mutex write_mutex_;
+    // One compaction at a time: each carries over the lists replaced since its source, which only works against the
+    // base it replaces
+    std::mutex compact_mutex_;
+    std::condition_variable_any compact_cv_;
+    size_t compact_threshold_;
+    std::atomic<uint64_t> compactions_ = 0;
+    // Last member, it is stopped and joined before the rest is destroyed
+    std::jthread compactor_;
+
+    void compactor_loop(const std::stop_token& stop);
+
+public:
+    // compact_threshold 0 picks max(1024, n / 32), background false leaves compaction to compact()
+    explicit MutableGraph(const Graph& graph, size_t compact_threshold = 0, bool background = true);
+
+    [[nodiscard]] std::shared_ptr<const GraphSnapshot> snapshot() const {
+        return current_.load(std::memory_order_acquire);
+    }
+
+    // Apply a batch atomically, returns the version of the snapshot that contains it. Throws std::out_of_range and
+    // applies nothing if an op names a vertex outside the graph.
+    uint64_t apply(const std::vector<EdgeOp>& ops);
+
+    // Merge the overlay of the current snapshot into a new base, blocks writers only while publishing. Waits for a
+    // compaction already running, manual or background.
+    void compact();
+
+    [[nodiscard]] uint64_t compactions() const {
+        return compactions_.load(std::memory_order_relaxed);
+    }
+};
+
+
+#endif //ALGO_SEMINAR_MUTABLE_GRAPH_H
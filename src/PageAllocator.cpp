@@ -0,0 +1,213 @@
+#include "PageAllocator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "MemoryAccounting.h"
+#include "Parallel.h"
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+
+namespace pages {
+
+namespace {
+
+constexpr size_t SMALL_PAGE = size_t{4} << 10;
+constexpr size_t HUGE_2M = size_t{2} << 20;
+constexpr size_t HUGE_1G = size_t{1} << 30;
+constexpr int MPOL_INTERLEAVE_MODE = 3;  // MPOL_INTERLEAVE of <linux/mempolicy.h>, which needs no libnuma
+
+struct Mapping {
+    size_t length;
+    memory::Subsystem subsystem;
+};
+
+std::atomic<Policy> current_policy;
+std::atomic<uint64_t> live_mappings{0}, mapped_bytes{0}, fallback_count{0}, interleave_failure_count{0};
+
+// Mapped blocks by address, to tell them from operator new blocks of the same size when they are freed
+std::mutex registry_mutex;
+std::unordered_map<void*, Mapping>& registry() {
+    static auto* mappings = new std::unordered_map<void*, Mapping>();
+    return *mappings;
+}
+
+size_t round_up(const size_t bytes, const size_t page) {
+    return (bytes + page - 1) / page * page;
+}
+
+// Node ids in a list like "0-1,3"
+std::vector<size_t> parse_node_list(const std::string& list) {
+    std::vector<size_t> nodes;
+    size_t pos = 0;
+    while (pos < list.size()) {
+        const size_t end = std::min(list.find(',', pos), list.size());
+        const std::string range = list.substr(pos, end - pos);
+        const size_t dash = range.find('-');
+        try {
+            const size_t first = std::stoul(range.substr(0, dash));
+            const size_t last = dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+            for (size_t node = first; node <= last; ++node) nodes.push_back(node);
+        } catch (const std::exception&) {}
+        pos = end + 1;
+    }
+    return nodes;
+}
+
+const std::vector<size_t>& memory_nodes() {
+    static const std::vector<size_t> nodes = [] {
+        std::ifstream f("/sys/devices/system/node/has_memory");
+        std::string list;
+        std::getline(f, list);
+        auto parsed = parse_node_list(list);
+        return parsed.empty() ? std::vector<size_t>{0} : parsed;
+    }();
+    return nodes;
+}
+
+void* map(const size_t length, const int flags) {
+    void* base = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+    return base == MAP_FAILED ? nullptr : base;
+}
+
+// A mapping starting on a 2 MB boundary, so that every 2 MB of it can become a transparent huge page
+void* map_aligned(const size_t length) {
+    auto* base = static_cast<std::byte*>(map(length + HUGE_2M, 0));
+    if (!base) return nullptr;
+    const auto address = reinterpret_cast<uintptr_t>(base);
+    const size_t head = round_up(address, HUGE_2M) - address;
+    if (head > 0) munmap(base, head);
+    munmap(base + head + length, HUGE_2M - head);
+    return base + head;
+}
+
+void interleave(void* block, const size_t length) {
+    const auto& nodes = memory_nodes();
+    if (nodes.size() < 2) return;
+    constexpr size_t BITS = 8 * sizeof(unsigned long);
+    // One word more than the highest node needs: the kernel ignores the last bit of maxnode
+    std::vector<unsigned long> mask(nodes.back() / BITS + 2, 0);
+    for (const size_t node : nodes) mask[node / BITS] |= 1ul << (node % BITS);
+    if (syscall(SYS_mbind, block, length, MPOL_INTERLEAVE_MODE, mask.data(), mask.size() * BITS, 0) != 0) {
+        interleave_failure_count.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// Faults every page in from the worker that parallel_for gives the matching part of [0, n) to
+void first_touch(void* block, const size_t length) {
+    auto* bytes = static_cast<volatile std::byte*>(block);
+    parallel::parallel_for(length / SMALL_PAGE, parallel::hardware_threads(),
+                           [bytes](const size_t begin, const size_t end, size_t) {
+                               for (size_t page = begin; page < end; ++page) bytes[page * SMALL_PAGE] = std::byte{0};
+                           });
+}
+
+// Length and address of a new mapping for bytes under policy, nullptr if the kernel has nothing to give
+std::pair<void*, size_t> map_for(const size_t bytes, const Policy policy) {
+    PageSize size = policy.size;
+    if (size == PageSize::Huge1G or size == PageSize::Huge2M) {
+        const bool giant = size == PageSize::Huge1G;
+        const size_t length = round_up(bytes, giant ? HUGE_1G : HUGE_2M);
+        if (void* block = map(length, MAP_HUGETLB | ((giant ? 30 : 21) << MAP_HUGE_SHIFT))) return {block, length};
+        fallback_count.fetch_add(1, std::memory_order_relaxed);
+        size = PageSize::Transparent;
+    }
+    if (size == PageSize::Transparent) {
+        const size_t length = round_up(bytes, HUGE_2M);
+        void* block = map_aligned(length);
+        if (block) madvise(block, length, MADV_HUGEPAGE);
+        return {block, length};
+    }
+    const size_t length = round_up(bytes, SMALL_PAGE);
+    return {map(length, 0), length};
+}
+
+}
+
+void set_policy(const Policy policy) {
+    current_policy.store(policy, std::memory_order_relaxed);
+}
+
+Policy policy() {
+    return current_policy.load(std::memory_order_relaxed);
+}
+
+Stats stats() {
+    return {live_mappings.load(std::memory_order_relaxed), mapped_bytes.load(std::memory_order_relaxed),
+            fallback_count.load(std::memory_order_relaxed), interleave_failure_count.load(std::memory_order_relaxed)};
+}
+
+size_t numa_nodes() {
+    return memory_nodes().size();
+}
+
+const char* page_size_name(const PageSize size) {
+    switch (size) {
+        case PageSize::Default: return "default";
+        case PageSize::Transparent: return "thp";
+        case PageSize::Huge2M: return "huge2m";
+        case PageSize::Huge1G: return "huge1g";
+    }
+    return "?";
+}
+
+const char* placement_name(const Placement placement) {
+    switch (placement) {
+        case Placement::Default: return "default";
+        case Placement::Interleave: return "interleave";
+        case Placement::FirstTouch: return "first-touch";
+    }
+    return "?";
+}
+
+void* allocate(const size_t bytes) {
+    const Policy p = policy();
+    if (bytes < LARGE_BYTES or (p.size == PageSize::Default and p.placement == Placement::Default)) {
+        return ::operator new(bytes);
+    }
+    const auto [block, length] = map_for(bytes, p);
+    if (!block) throw std::bad_alloc();
+    if (p.placement == Placement::Interleave) interleave(block, length);
+    if (p.placement == Placement::FirstTouch) first_touch(block, length);
+
+    const memory::Subsystem subsystem = memory::charge_external(static_cast<int64_t>(length));
+    {
+        MEMORY_SCOPE(Other);
+        const std::lock_guard lock(registry_mutex);
+        registry().emplace(block, Mapping{length, subsystem});
+    }
+    live_mappings.fetch_add(1, std::memory_order_relaxed);
+    mapped_bytes.fetch_add(length, std::memory_order_relaxed);
+    return block;
+}
+
+void deallocate(void* block, const size_t bytes) noexcept {
+    if (!block) return;
+    if (bytes >= LARGE_BYTES and live_mappings.load(std::memory_order_relaxed) > 0) {
+        std::unique_lock lock(registry_mutex);
+        if (const auto it = registry().find(block); it != registry().end()) {
+            const Mapping mapping = it->second;
+            registry().erase(it);
+            lock.unlock();
+            munmap(block, mapping.length);
+            memory::release_external(mapping.subsystem, static_cast<int64_t>(mapping.length));
+            live_mappings.fetch_sub(1, std::memory_order_relaxed);
+            mapped_bytes.fetch_sub(mapping.length, std::memory_order_relaxed);
+            return;
+        }
+    }
+    ::operator delete(block, bytes);
+}
+
+}
@@ -0,0 +1,99 @@
+#ifndef ALGO_SEMINAR_PAGE_ALLOCATOR_H
+#define ALGO_SEMINAR_PAGE_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+/*
+Placement of the large arrays: CSRGraph adjacency, the per-vertex arrays of BMSSP, Dijkstra and MultiSourceSSSP and
+the key indices of the BMSSP queues. They are PageVectors, whose allocator takes blocks of at least LARGE_BYTES
+straight from mmap when a policy other than the default is set, and hands everything else to operator new.
+ - Pages: Transparent maps 2 MB aligned and asks for transparent huge pages with madvise(MADV_HUGEPAGE), Huge2M and
+   Huge1G map from the hugetlbfs pool with MAP_HUGETLB. An empty pool (vm.nr_hugepages is 0 by default) falls back to
+   Transparent and is counted in stats().fallbacks.
+ - Placement: Interleave spreads the pages round-robin over the online NUMA nodes with mbind(MPOL_INTERLEAVE),
+   FirstTouch faults the pages in with parallel_for on hardware_threads() workers, so chunk i of a block lands on the
+   node of the thread that also works on chunk i of the vertex range. Both are no-ops on a single node machine, apart
+   from FirstTouch paying for the faults up front.
+The policy is read when a block is allocated, so set it before building the graph and the engines. Mapped blocks are
+charged to the current MEMORY_SCOPE like any other allocation.
+*/
+namespace pages {
+
+enum class PageSize : uint8_t {
+    Default,  // whatever the kernel does for malloc'ed memory
+    Transparent,
+    Huge2M,
+    Huge1G,
+};
+
+enum class Placement : uint8_t {
+    Default,  // first touch by whichever thread writes the page first
+    Interleave,
+    FirstTouch,
+};
+
+struct Policy {
+    PageSize size = PageSize::Default;
+    Placement placement = Placement::Default;
+};
+
+// Smaller blocks always come from operator new, a mapping of their own would waste most of a huge page
+inline constexpr size_t LARGE_BYTES = size_t{1} << 20;
+
+struct Stats {
+    uint64_t mappings = 0;  // blocks currently mapped
+    uint64_t bytes = 0;  // bytes currently mapped, rounded up to whole pages
+    uint64_t fallbacks = 0;  // MAP_HUGETLB requests the pool could not serve, since the start
+    uint64_t interleave_failures = 0;  // mbind calls the kernel refused, since the start
+};
+
+void set_policy(Policy policy);
+Policy policy();
+Stats stats();
+
+// NUMA nodes with memory, from /sys/devices/system/node; 1 where that is unavailable
+size_t numa_nodes();
+
+const char* page_size_name(PageSize size);
+const char* placement_name(Placement placement);
+
+// Never returns null, throws std::bad_alloc
+void* allocate(size_t bytes);
+// bytes must be what the block was allocated with
+void deallocate(void* block, size_t bytes) noexcept;
+
+template <typename T>
+struct Allocator {
+    using value_type = T;
+
+    Allocator() = default;
+
+    template <typename U>
+    Allocator(const Allocator<U>&) {}
+
+    T* allocate(const size_t count) {
+        static_assert(alignof(T) <= alignof(std::max_align_t));
+        if (count > SIZE_MAX / sizeof(T)) throw std::bad_array_new_length();
+        return static_cast<T*>(pages::allocate(count * sizeof(T)));
+    }
+
+    void deallocate(T* block, const size_t count) noexcept {
+        pages::deallocate(block, count * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const Allocator<U>&) const {
+        return true;
+    }
+};
+
+}
+
+template <typename T>
+using PageVector = std::vector<T, pages::Allocator<T>>;
+
+
+#endif //ALGO_SEMINAR_PAGE_ALLOCATOR_H
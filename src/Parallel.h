@@ -0,0 +1,62 @@
+#ifndef ALGO_SEMINAR_PARALLEL_H
+#define ALGO_SEMINAR_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace parallel {
+
+inline size_t hardware_threads() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Splits [0, n) into `threads` contiguous chunks and calls fn(begin, end, tid) once per chunk. Chunk tid always
+// covers lower indices than chunk tid + 1, so per-thread buffers concatenated by tid keep the input order.
+// With a single thread (or a single chunk) fn runs inline on the calling thread. The thread count is capped by the
+// hardware, oversubscribed workers only wait for each other at the join.
+template <typename Fn>
+void parallel_for(const size_t n, const size_t threads, Fn&& fn) {
+    static const size_t hw = hardware_threads();
+    const size_t chunks = std::max<size_t>(1, std::min({threads, n, hw}));
+    if (chunks == 1) {
+        fn(size_t{0}, n, size_t{0});
+        return;
+    }
+    const size_t step = (n + chunks - 1) / chunks;
+    std::vector<std::jthread> workers;
+    workers.reserve(chunks - 1);
+    for (size_t tid = 1; tid < chunks; ++tid) {
+        const size_t begin = std::min(n, tid * step);
+        const size_t end = std::min(n, begin + step);
+        workers.emplace_back([&fn, begin, end, tid] { fn(begin, end, tid); });
+    }
+    fn(size_t{0}, std::min(n, step), size_t{0});
+}
+
+// Lowers target to value if value is smaller. Returns true if this call lowered it.
+template <typename T>
+bool atomic_min(T& target, const T value) {
+    std::atomic_ref<T> ref(target);
+    T cur = ref.load(std::memory_order_relaxed);
+    while (value < cur) {
+        if (ref.compare_exchange_weak(cur, value, std::memory_order_relaxed)) return true;
+    }
+    return false;
+}
+
+template <typename T>
+T atomic_load(T& target) {
+    return std::atomic_ref<T>(target).load(std::memory_order_relaxed);
+}
+
+template <typename T>
+void atomic_store(T& target, const T value) {
+    std::atomic_ref<T>(target).store(value, std::memory_order_relaxed);
+}
+
+}
+
+#endif //ALGO_SEMINAR_PARALLEL_H
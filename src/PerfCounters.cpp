@@ -0,0 +1,134 @@
+#include "PerfCounters.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace perf {
+
+namespace {
+
+constexpr size_t EVENTS = 4;
+
+/*
+The four counters of one thread as a perf event group led by cycles, so one read() returns all of them from the same
+scheduling window. A member the PMU does not offer (some VMs lack cache misses) is left out and reads as 0; without
+the leader nothing is counted.
+*/
+class CounterGroup {
+    int fds_[EVENTS] = {-1, -1, -1, -1};
+    // Position of each event in the group read, -1 if it is not open
+    int slot_[EVENTS] = {-1, -1, -1, -1};
+    int open_ = 0;
+
+public:
+    CounterGroup() {
+#if defined(__linux__)
+        static constexpr uint64_t configs[EVENTS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                                     PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+        for (size_t i = 0; i < EVENTS; ++i) {
+            if (i > 0 and fds_[0] < 0) break;
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[i];
+            attr.disabled = i == 0 ? 1 : 0;
+            // User space only, which perf_event_paranoid = 2 (the common default) still allows
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP;
+            const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, i == 0 ? -1 : fds_[0], 0));
+            if (fd < 0) continue;
+            fds_[i] = fd;
+            slot_[i] = open_++;
+        }
+        if (fds_[0] >= 0) {
+            ioctl(fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+
+    ~CounterGroup() {
+#if defined(__linux__)
+        for (const int fd : fds_) {
+            if (fd >= 0) close(fd);
+        }
+#endif
+    }
+
+    CounterGroup(const CounterGroup&) = delete;
+    CounterGroup& operator=(const CounterGroup&) = delete;
+
+    [[nodiscard]] bool available() const {
+        return fds_[0] >= 0;
+    }
+
+    void read(Sample& s) const {
+#if defined(__linux__)
+        if (!available()) return;
+        // { nr, value[nr] }
+        uint64_t buf[1 + EVENTS];
+        const auto expected = static_cast<ssize_t>(sizeof(uint64_t) * (1 + open_));
+        if (::read(fds_[0], buf, sizeof(buf)) < expected) return;
+        const auto value = [&](const size_t i) { return slot_[i] < 0 ? 0 : buf[1 + slot_[i]]; };
+        s.cycles = value(0);
+        s.instructions = value(1);
+        s.cache_misses = value(2);
+        s.branch_misses = value(3);
+#else
+        (void)s;
+#endif
+    }
+};
+
+thread_local CounterGroup group;
+thread_local std::array<Sample, PHASES> phase_totals;
+
+}
+
+const char* phase_name(const Phase phase) {
+    switch (phase) {
+        case Phase::FindPivots: return "find_pivots";
+        case Phase::BaseCase: return "base_case";
+        case Phase::Relax: return "relax";
+        case Phase::Pull: return "pull";
+        case Phase::Consolidate: return "consolidate";
+    }
+    return "?";
+}
+
+bool counters_available() {
+    return group.available();
+}
+
+const std::array<Sample, PHASES>& totals() {
+    return phase_totals;
+}
+
+void reset() {
+    phase_totals = {};
+}
+
+Scope::Scope(const Phase phase) : phase_(phase) {
+    group.read(start_);
+    start_time_ = std::chrono::steady_clock::now();
+}
+
+Scope::~Scope() {
+    const auto end_time = std::chrono::steady_clock::now();
+    Sample end;
+    group.read(end);
+    Sample& total = phase_totals[static_cast<size_t>(phase_)];
+    ++total.calls;
+    total.cycles += end.cycles - start_.cycles;
+    total.instructions += end.instructions - start_.instructions;
+    total.cache_misses += end.cache_misses - start_.cache_misses;
+    total.branch_misses += end.branch_misses - start_.branch_misses;
+    total.ms += std::chrono::duration<double, std::milli>(end_time - start_time_).count();
+}
+
+}
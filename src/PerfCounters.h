@@ -0,0 +1,75 @@
+#ifndef ALGO_SEMINAR_PERF_COUNTERS_H
+#define ALGO_SEMINAR_PERF_COUNTERS_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/*
+Hardware counters around the hot phases of the engines. PERF_SCOPE(Phase) at the top of a block adds the cycles,
+instructions, cache misses, branch misses and wall time of the block to the totals of that phase. The counters come
+from one perf_event_open group per thread and count user space of the calling thread only, so work handed to
+parallel_for workers is missing from them (the time is not). Where perf_event_open is not allowed (containers,
+perf_event_paranoid > 2, no PMU, not Linux) a scope still counts calls and time and counters_available() is false.
+Scopes cost two read() calls each, so they only exist when PERF_COUNTERS is defined to 1 (CMake option
+PERF_COUNTERS); otherwise PERF_SCOPE expands to nothing.
+*/
+#ifndef PERF_COUNTERS
+#define PERF_COUNTERS 0
+#endif
+
+#if PERF_COUNTERS
+#define PERF_SCOPE(phase) const perf::Scope perf_scope(perf::Phase::phase)
+#else
+#define PERF_SCOPE(phase)
+#endif
+
+namespace perf {
+
+enum class Phase {
+    FindPivots,
+    BaseCase,
+    Relax,  // relax_completed in bmssp
+    Pull,
+    Consolidate,
+};
+
+inline constexpr size_t PHASES = 5;
+
+const char* phase_name(Phase phase);
+
+struct Sample {
+    uint64_t calls = 0;
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t cache_misses = 0;
+    uint64_t branch_misses = 0;
+    double ms = 0;
+};
+
+// Opens the counters of the calling thread on first use, false if they could not be opened
+bool counters_available();
+
+// Phase totals of the calling thread since the last reset
+const std::array<Sample, PHASES>& totals();
+
+void reset();
+
+class Scope {
+    Phase phase_;
+    Sample start_;
+    std::chrono::steady_clock::time_point start_time_;
+
+public:
+    explicit Scope(Phase phase);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+};
+
+}
+
+
+#endif //ALGO_SEMINAR_PERF_COUNTERS_H
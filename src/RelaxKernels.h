@@ -0,0 +1,212 @@
+#ifndef ALGO_SEMINAR_RELAX_KERNELS_H
+#define ALGO_SEMINAR_RELAX_KERNELS_H
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <utility>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "Graph.h"
+
+/*
+Relaxation of the out-arcs of one vertex u with distance d_u: lower(v, cand) is called for every arc (v, w) with
+cand = d_u + w < bound and cand < dist[v] (≤ if Inclusive), in arc order, and is expected to store cand into dist[v].
+Each test reads dist[v] at a random place, which the plain loop (relax_scalar) does one arc and one mispredicted
+branch at a time. relax instead takes the arcs of adjacencies with at least MIN_GROUPED of them GROUP at a time:
+ - dist[v] of the next group is prefetched while the current one is tested,
+ - a group is tested at once, targets and weights loaded from the Edge array and dist[v] gathered with one AVX-512
+   gather (two AVX2 ones), the end of the adjacency masked off,
+ - lower is only called for arcs that passed, each tested again first as lower may just have lowered dist[v] through
+   a parallel arc of the same group.
+dist only gets lower while relax runs, so an arc the group test rejects would fail the plain test too: both call lower
+for the same arcs with the same values. dist must not be written by other threads meanwhile; concurrent relaxations
+(relax_layer of BMSSP on several threads) and other distance layouts use for_each_prefetched and test themselves.
+The AVX-512 and AVX2 paths are chosen at compile time (-march=native), the scalar path is always available. Arcs that
+are not contiguous in memory always take relax_scalar.
+*/
+namespace relax_kernels {
+
+inline constexpr size_t GROUP = 8;
+// Shorter adjacencies take the plain loop: nothing to prefetch ahead, and out-of-order execution already overlaps their
+// few misses better than a gather does
+inline constexpr size_t MIN_GROUPED = GROUP;
+
+static_assert(sizeof(Edge) == 2 * sizeof(uint64_t), "the group tests load an Edge as target and weight");
+
+// Arcs that live in memory (Graph, CSRGraph, GraphSnapshot) rather than being computed on the fly (GridGraph). Only
+// those are worth fetching ahead of the vertex that reads them.
+template <typename G>
+concept StoredArcs = std::ranges::borrowed_range<decltype(std::declval<const G&>().neighbors(0))>;
+
+template <typename Arcs>
+concept ContiguousArcs = std::ranges::contiguous_range<Arcs> and std::ranges::sized_range<Arcs>;
+
+template <typename T>
+void prefetch(const T* address) {
+    __builtin_prefetch(address, 1, 3);
+}
+
+inline void prefetch_targets(const Edge* arcs, const size_t count, const double* dist) {
+    for (size_t i = 0; i < count; ++i) prefetch(dist + arcs[i].to_id_);
+}
+
+// dist[v] of the first GROUP arcs, for a vertex that is relaxed next
+template <typename Arcs>
+void prefetch_targets(const Arcs& arcs, const double* dist) {
+    if constexpr (ContiguousArcs<Arcs>) {
+        prefetch_targets(std::ranges::data(arcs), std::min<size_t>(GROUP, std::ranges::size(arcs)), dist);
+    }
+}
+
+template <bool Inclusive>
+bool passes(const double cand, const double bound, const double current) {
+    return cand < bound and (Inclusive ? cand <= current : cand < current);
+}
+
+template <bool Inclusive, typename Arcs, typename Lower>
+void relax_scalar(const Arcs& arcs, const double d_u, const double bound, const double* dist, Lower&& lower) {
+    for (const auto& [v, w] : arcs) {
+        const double cand = d_u + w;
+        if (passes<Inclusive>(cand, bound, dist[v])) lower(v, cand);
+    }
+}
+
+// Bit i set if arc i of arcs[0, count) passes against the current dist, count ≤ GROUP
+template <bool Inclusive>
+uint32_t test_group_scalar(const Edge* arcs, const size_t count, const double d_u, const double bound,
+                           const double* dist) {
+    uint32_t pass = 0;
+    for (size_t i = 0; i < count; ++i) {
+        pass |= static_cast<uint32_t>(passes<Inclusive>(d_u + arcs[i].weight_, bound, dist[arcs[i].to_id_])) << i;
+    }
+    return pass;
+}
+
+#if defined(__AVX2__)
+template <bool Inclusive>
+uint32_t test_group4_avx2(const Edge* arcs, const size_t count, const __m256d d_u, const __m256d bound,
+                          const double* dist) {
+    // Arcs 0, 1 and 2, 3 as (target, weight) qword pairs, the qwords past count masked off
+    const __m256i qwords = _mm256_set1_epi64x(static_cast<int64_t>(2 * std::min<size_t>(count, 4)));
+    const __m256i lo_mask = _mm256_cmpgt_epi64(qwords, _mm256_setr_epi64x(0, 1, 2, 3));
+    const __m256i hi_mask = _mm256_cmpgt_epi64(qwords, _mm256_setr_epi64x(4, 5, 6, 7));
+    const auto* base = reinterpret_cast<const long long*>(arcs);
+    const __m256i lo = _mm256_maskload_epi64(base, lo_mask);
+    const __m256i hi = _mm256_maskload_epi64(base + 4, hi_mask);
+    // unpack gives the order 0 2 1 3, the permute restores 0 1 2 3
+    const __m256i ids = _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(lo, hi), 0b11011000);
+    const __m256d w = _mm256_castsi256_pd(_mm256_permute4x64_epi64(_mm256_unpackhi_epi64(lo, hi), 0b11011000));
+    const __m256i lanes = _mm256_cmpgt_epi64(_mm256_set1_epi64x(static_cast<int64_t>(count)),
+                                             _mm256_setr_epi64x(0, 1, 2, 3));
+    const __m256d current = _mm256_mask_i64gather_pd(_mm256_setzero_pd(), dist, ids, _mm256_castsi256_pd(lanes), 8);
+    const __m256d cand = _mm256_add_pd(d_u, w);
+    __m256d pass = _mm256_and_pd(_mm256_castsi256_pd(lanes), _mm256_cmp_pd(cand, bound, _CMP_LT_OQ));
+    pass = _mm256_and_pd(pass, _mm256_cmp_pd(cand, current, Inclusive ? _CMP_LE_OQ : _CMP_LT_OQ));
+    return static_cast<uint32_t>(_mm256_movemask_pd(pass));
+}
+
+template <bool Inclusive>
+uint32_t test_group_avx2(const Edge* arcs, const size_t count, const double d_u, const double bound,
+                         const double* dist) {
+    const __m256d d = _mm256_set1_pd(d_u), b = _mm256_set1_pd(bound);
+    uint32_t pass = test_group4_avx2<Inclusive>(arcs, count, d, b, dist);
+    if (count > 4) pass |= test_group4_avx2<Inclusive>(arcs + 4, count - 4, d, b, dist) << 4;
+    return pass;
+}
+#endif
+
+#if defined(__AVX512F__)
+template <bool Inclusive>
+uint32_t test_group_avx512(const Edge* arcs, const size_t count, const double d_u, const double bound,
+                           const double* dist) {
+    const __mmask8 lanes = static_cast<__mmask8>((1u << count) - 1);
+    // Arcs 0-3 and 4-7 as (target, weight) qword pairs, the qwords past count masked off
+    const size_t lo_arcs = std::min<size_t>(count, 4), hi_arcs = count - lo_arcs;
+    const auto lo_mask = static_cast<__mmask8>((1u << (2 * lo_arcs)) - 1);
+    const auto hi_mask = static_cast<__mmask8>((1u << (2 * hi_arcs)) - 1);
+    const __m512i lo = _mm512_maskz_loadu_epi64(lo_mask, arcs);
+    const __m512i hi = _mm512_maskz_loadu_epi64(hi_mask, arcs + 4);
+    const __m512i ids = _mm512_permutex2var_epi64(lo, _mm512_set_epi64(14, 12, 10, 8, 6, 4, 2, 0), hi);
+    const __m512d w = _mm512_castsi512_pd(
+        _mm512_permutex2var_epi64(lo, _mm512_set_epi64(15, 13, 11, 9, 7, 5, 3, 1), hi));
+    const __m512d current = _mm512_mask_i64gather_pd(_mm512_setzero_pd(), lanes, ids, dist, 8);
+    const __m512d cand = _mm512_add_pd(_mm512_set1_pd(d_u), w);
+    __mmask8 pass = _mm512_mask_cmp_pd_mask(lanes, cand, _mm512_set1_pd(bound), _CMP_LT_OQ);
+    pass = _mm512_mask_cmp_pd_mask(pass, cand, current, Inclusive ? _CMP_LE_OQ : _CMP_LT_OQ);
+    return pass;
+}
+#endif
+
+template <bool Inclusive>
+uint32_t test_group(const Edge* arcs, const size_t count, const double d_u, const double bound, const double* dist) {
+#if defined(__AVX512F__)
+    return test_group_avx512<Inclusive>(arcs, count, d_u, bound, dist);
+#elif defined(__AVX2__)
+    return test_group_avx2<Inclusive>(arcs, count, d_u, bound, dist);
+#else
+    return test_group_scalar<Inclusive>(arcs, count, d_u, bound, dist);
+#endif
+}
+
+template <bool Inclusive, typename Arcs, typename Lower>
+void relax(const Arcs& arcs, const double d_u, const double bound, const double* dist, Lower&& lower) {
+    if constexpr (!ContiguousArcs<Arcs>) {
+        relax_scalar<Inclusive>(arcs, d_u, bound, dist, lower);
+    } else {
+        const Edge* edges = std::ranges::data(arcs);
+        const size_t count = std::ranges::size(arcs);
+        if (count < MIN_GROUPED) {
+            relax_scalar<Inclusive>(arcs, d_u, bound, dist, lower);
+            return;
+        }
+        for (size_t first = 0; first < count; first += GROUP) {
+            const size_t group = std::min(GROUP, count - first);
+            if (first + GROUP < count) {
+                prefetch_targets(edges + first + GROUP, std::min(GROUP, count - first - GROUP), dist);
+            }
+            for (uint32_t pass = test_group<Inclusive>(edges + first, group, d_u, bound, dist); pass != 0;
+                 pass &= pass - 1) {
+                const Edge& arc = edges[first + std::countr_zero(pass)];
+                const double cand = d_u + arc.weight_;
+                if (passes<Inclusive>(cand, bound, dist[arc.to_id_])) lower(arc.to_id_, cand);
+            }
+        }
+    }
+}
+
+// visit(v, w) for every arc in order, with fetch(v) called GROUP arcs ahead to prefetch whatever visit will read for v.
+// For relaxations that test and update their distances themselves, atomically when threads share them or in a layout
+// of their own.
+template <typename Arcs, typename Fetch, typename Visit>
+void for_each_prefetched(const Arcs& arcs, Fetch&& fetch, Visit&& visit) {
+    if constexpr (!ContiguousArcs<Arcs>) {
+        for (const auto& [v, w] : arcs) visit(v, w);
+    } else {
+        const Edge* edges = std::ranges::data(arcs);
+        const size_t count = std::ranges::size(arcs);
+        for (size_t i = 0; i < count; ++i) {
+            if (i + GROUP < count) fetch(edges[i + GROUP].to_id_);
+            visit(edges[i].to_id_, edges[i].weight_);
+        }
+    }
+}
+
+inline const char* isa_name() {
+#if defined(__AVX512F__)
+    return "avx512";
+#elif defined(__AVX2__)
+    return "avx2";
+#else
+    return "scalar";
+#endif
+}
+
+}
+
+#endif //ALGO_SEMINAR_RELAX_KERNELS_H
@@ -0,0 +1,124 @@
+#include "ResultCache.h"
+
+#include <bit>
+#include <functional>
+
+size_t CacheKeyHash::operator()(const CacheKey& key) const noexcept {
+    size_t h = std::hash<uint64_t>{}(key.version);
+    h ^= std::hash<uint64_t>{}(key.source) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    h ^= std::hash<uint64_t>{}(std::bit_cast<uint64_t>(key.bound)) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    return h;
+}
+
+CachedResult::CachedResult(const std::vector<double>& dist, const CachePrecision precision) : precision_(precision) {
+    if (precision_ == CachePrecision::Float32) {
+        f32_.assign(dist.begin(), dist.end());
+    } else {
+        f64_ = dist;
+    }
+}
+
+CachedResult::CachedResult(const std::vector<Pair>& reached, const CachePrecision precision)
+    : precision_(precision), sparse_(true) {
+    ids_.reserve(reached.size());
+    for (const auto& [v, d] : reached) {
+        ids_.push_back(v);
+        if (precision_ == CachePrecision::Float32) {
+            f32_.push_back(static_cast<float>(d));
+        } else {
+            f64_.push_back(d);
+        }
+    }
+}
+
+size_t CachedResult::bytes() const {
+    return sizeof(CachedResult) + f32_.size() * sizeof(float) + f64_.size() * sizeof(double)
+           + ids_.size() * sizeof(uint64_t);
+}
+
+std::vector<double> CachedResult::dense() const {
+    if (precision_ == CachePrecision::Float64) return f64_;
+    return {f32_.begin(), f32_.end()};
+}
+
+std::vector<Pair> CachedResult::pairs() const {
+    std::vector<Pair> reached;
+    reached.reserve(ids_.size());
+    for (size_t i = 0; i < ids_.size(); ++i) {
+        reached.emplace_back(ids_[i], value(i));
+    }
+    return reached;
+}
+
+ResultCache::ResultCache(const size_t budget_bytes, const CachePrecision precision)
+    : budget_bytes_(budget_bytes), precision_(precision) {}
+
+void ResultCache::observe_version_locked(const uint64_t version) {
+    if (version <= newest_version_) return;
+    newest_version_ = version;
+    for (auto it = lru_.begin(); it != lru_.end();) {
+        if (it->first.version < version) {
+            stats_.bytes -= it->second->bytes();
+            stats_.invalidations++;
+            index_.erase(it->first);
+            it = lru_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ResultCache::evict_locked() {
+    while (stats_.bytes > budget_bytes_ and !lru_.empty()) {
+        const auto& [key, result] = lru_.back();
+        stats_.bytes -= result->bytes();
+        stats_.evictions++;
+        index_.erase(key);
+        lru_.pop_back();
+    }
+}
+
+std::shared_ptr<const CachedResult> ResultCache::find(const CacheKey& key) {
+    std::lock_guard lock(mutex_);
+    observe_version_locked(key.version);
+    const auto it = index_.find(key);
+    if (it == index_.end()) {
+        stats_.misses++;
+        return nullptr;
+    }
+    stats_.hits++;
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return it->second->second;
+}
+
+void ResultCache::insert(const CacheKey& key, std::shared_ptr<const CachedResult> result) {
+    const size_t bytes = result->bytes();
+    std::lock_guard lock(mutex_);
+    observe_version_locked(key.version);
+    // Computed against a version that was replaced meanwhile, or too large to ever fit
+    if (key.version < newest_version_ or bytes > budget_bytes_) return;
+
+    if (const auto it = index_.find(key); it != index_.end()) {
+        stats_.bytes -= it->second->second->bytes();
+        lru_.erase(it->second);
+        index_.erase(it);
+    }
+    lru_.emplace_front(key, std::move(result));
+    index_.emplace(key, lru_.begin());
+    stats_.bytes += bytes;
+    evict_locked();
+}
+
+void ResultCache::clear() {
+    std::lock_guard lock(mutex_);
+    lru_.clear();
+    index_.clear();
+    stats_.bytes = 0;
+}
+
+CacheStats ResultCache::stats() const {
+    std::lock_guard lock(mutex_);
+    CacheStats s = stats_;
+    s.entries = lru_.size();
+    return s;
+}
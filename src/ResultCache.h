@@ -0,0 +1,123 @@
+#ifndef ALGO_SEMINAR_RESULT_CACHE_H
+#define ALGO_SEMINAR_RESULT_CACHE_H
+
+#include <cstdint>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "BlockLinkedList.h"
+
+// Graph version (Graph::version, GraphSnapshot::version), source and distance bound, INF for a full run
+struct CacheKey {
+    uint64_t version;
+    uint64_t source;
+    double bound = std::numeric_limits<double>::infinity();
+
+    bool operator==(const CacheKey&) const = default;
+};
+
+struct CacheKeyHash {
+    size_t operator()(const CacheKey& key) const noexcept;
+};
+
+// Float64, the default, stores results exactly. Float32 halves the footprint and keeps about 7 significant digits, opt
+// in where distances are only compared or displayed.
+enum class CachePrecision {Float64, Float32};
+
+struct CacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;  // entries dropped for the memory budget
+    uint64_t invalidations = 0;  // entries dropped because the graph moved on to a newer version
+    size_t entries = 0;
+    size_t bytes = 0;
+};
+
+// One cached result: a dense distance array or the sparse output of a bounded query
+class CachedResult {
+    friend class ResultCache;
+
+    CachePrecision precision_;
+    bool sparse_ = false;
+    std::vector<float> f32_;
+    std::vector<double> f64_;
+    std::vector<uint64_t> ids_;  // sparse results only
+
+    [[nodiscard]] double value(const size_t i) const {
+        return precision_ == CachePrecision::Float32 ? static_cast<double>(f32_[i]) : f64_[i];
+    }
+
+public:
+    CachedResult(const std::vector<double>& dist, CachePrecision precision);
+
+    CachedResult(const std::vector<Pair>& reached, CachePrecision precision);
+
+    [[nodiscard]] size_t bytes() const;
+
+    // Distances of a dense result
+    [[nodiscard]] std::vector<double> dense() const;
+
+    // (vertex, distance) pairs of a sparse result
+    [[nodiscard]] std::vector<Pair> pairs() const;
+};
+
+/*
+LRU cache for SSSP results of one graph, keyed by (graph version, source, bound). Entries are charged
+with their payload size against a byte budget and the least recently used ones go first. A key with a newer graph
+version than any seen before drops every entry of older versions, they can never hit again. All members are safe to
+call concurrently; results are computed outside the lock, so two threads missing on the same key both compute it.
+A miss returns the result as it was stored, so the answer to a query does not depend on whether it hit.
+*/
+class ResultCache {
+    using LruList = std::list<std::pair<CacheKey, std::shared_ptr<const CachedResult>>>;
+
+    size_t budget_bytes_;
+    CachePrecision precision_;
+
+    mutable std::mutex mutex_;
+    LruList lru_;  // most recently used first
+    std::unordered_map<CacheKey, LruList::iterator, CacheKeyHash> index_;
+    uint64_t newest_version_ = 0;
+    CacheStats stats_;
+
+    void observe_version_locked(uint64_t version);
+    void evict_locked();
+
+public:
+    explicit ResultCache(size_t budget_bytes, CachePrecision precision = CachePrecision::Float64);
+
+    // nullptr on a miss
+    std::shared_ptr<const CachedResult> find(const CacheKey& key);
+
+    void insert(const CacheKey& key, std::shared_ptr<const CachedResult> result);
+
+    // Cached distances for key, computed by compute() (returning std::vector<double>) on a miss
+    template <typename Compute>
+    std::vector<double> dense(const CacheKey& key, Compute&& compute) {
+        if (const auto hit = find(key)) return hit->dense();
+        auto result = std::make_shared<const CachedResult>(compute(), precision_);
+        insert(key, result);
+        return result->dense();
+    }
+
+    // Cached bounded result for key, computed by compute() (returning std::vector<Pair>) on a miss
+    template <typename Compute>
+    std::vector<Pair> bounded(const CacheKey& key, Compute&& compute) {
+        if (const auto hit = find(key)) return hit->pairs();
+        auto result = std::make_shared<const CachedResult>(compute(), precision_);
+        insert(key, result);
+        return result->pairs();
+    }
+
+    // Drop every entry
+    void clear();
+
+    [[nodiscard]] CacheStats stats() const;
+};
+
+
+#endif //ALGO_SEMINAR_RESULT_CACHE_H
@@ -0,0 +1,181 @@
+#include "SSSPDispatcher.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#include "BMSSP.h"
+#include "Dijkstra.h"
+#include "GraphFactory.h"
+
+namespace dispatch {
+
+const char* engine_name(const Engine engine) {
+    switch (engine) {
+        case Engine::HeapDijkstra: return "heap-dijkstra";
+        case Engine::FibDijkstra: return "fib-dijkstra";
+        case Engine::BMSSP: return "bmssp";
+    }
+    return "?";
+}
+
+std::array<double, 5> GraphStats::features() const {
+    return {
+        std::log2(static_cast<double>(std::max<size_t>(n, 1))),
+        std::log2(std::max(mean_degree, 1.0)),
+        degree_cv,
+        weight_cv,
+        std::log2(std::max(weight_ratio, 1.0)),
+    };
+}
+
+GraphStats graph_stats(const Graph& graph) {
+    GraphStats s;
+    s.n = graph.size();
+    double deg_sum = 0, deg_sq = 0;
+    double w_sum = 0, w_sq = 0;
+    double w_min = std::numeric_limits<double>::infinity(), w_max = 0;
+    for (const auto& vertex : graph.get_vertices()) {
+        const auto degree = static_cast<double>(vertex.outgoing_edges_.size());
+        deg_sum += degree;
+        deg_sq += degree * degree;
+        for (const auto& [to, w] : vertex.outgoing_edges_) {
+            w_sum += w;
+            w_sq += w * w;
+            w_min = std::min(w_min, w);
+            w_max = std::max(w_max, w);
+        }
+    }
+    s.arcs = static_cast<size_t>(deg_sum);
+    if (s.n == 0) return s;
+
+    s.mean_degree = deg_sum / static_cast<double>(s.n);
+    const double deg_var = deg_sq / static_cast<double>(s.n) - s.mean_degree * s.mean_degree;
+    s.degree_cv = s.mean_degree > 0 ? std::sqrt(std::max(deg_var, 0.0)) / s.mean_degree : 0;
+    if (s.arcs > 0) {
+        const double w_mean = w_sum / deg_sum;
+        const double w_var = w_sq / deg_sum - w_mean * w_mean;
+        s.weight_cv = w_mean > 0 ? std::sqrt(std::max(w_var, 0.0)) / w_mean : 0;
+        // Zero weights would make the ratio infinite, which neither compares nor round-trips through the table
+        s.weight_ratio = w_max / std::max(w_min, 1e-9);
+    }
+    return s;
+}
+
+Engine CalibrationPoint::fastest() const {
+    size_t best = 0;
+    for (size_t e = 1; e < ms.size(); ++e) {
+        if (ms[e] < ms[best]) best = e;
+    }
+    return ENGINES[best];
+}
+
+std::string CalibrationTable::path() {
+    const char* env = std::getenv("SSSP_CALIBRATION_FILE");
+    return env != nullptr ? env : "sssp_calibration.txt";
+}
+
+CalibrationTable CalibrationTable::load() {
+    CalibrationTable table;
+    std::ifstream f(path());
+    CalibrationPoint p;
+    auto& s = p.stats;
+    while (f >> s.n >> s.arcs >> s.mean_degree >> s.degree_cv >> s.weight_cv >> s.weight_ratio
+             >> p.ms[0] >> p.ms[1] >> p.ms[2]) {
+        table.points.push_back(p);
+    }
+    return table;
+}
+
+void CalibrationTable::save() const {
+    std::ofstream f(path(), std::ios::trunc);
+    for (const auto& [s, ms] : points) {
+        f << s.n << ' ' << s.arcs << ' ' << s.mean_degree << ' ' << s.degree_cv << ' ' << s.weight_cv << ' '
+          << s.weight_ratio << ' ' << ms[0] << ' ' << ms[1] << ' ' << ms[2] << '\n';
+    }
+}
+
+CalibrationPoint CalibrationTable::measure(Graph& graph, const size_t sources, const size_t threads) {
+    CalibrationPoint p;
+    p.stats = graph_stats(graph);
+    const auto starts = get_start_vertices(graph, static_cast<int>(std::min(sources, graph.size())));
+    for (size_t e = 0; e < ENGINES.size(); ++e) {
+        double total = 0;
+        for (const Vertex* src : starts) {
+            const auto start = std::chrono::steady_clock::now();
+            SSSPDispatcher::run_engine(graph, src, ENGINES[e], threads);
+            const auto end = std::chrono::steady_clock::now();
+            total += std::chrono::duration<double, std::milli>(end - start).count();
+        }
+        p.ms[e] = total / static_cast<double>(starts.size());
+    }
+    return p;
+}
+
+SSSPDispatcher::SSSPDispatcher(Graph& graph) : SSSPDispatcher(graph, CalibrationTable::load()) {}
+
+SSSPDispatcher::SSSPDispatcher(Graph& graph, CalibrationTable table)
+    : graph_(graph), stats_(graph_stats(graph)), table_(std::move(table)), engine_(Engine::HeapDijkstra) {
+    if (table_.points.empty()) {
+        reason_ = "no calibration table at " + CalibrationTable::path();
+        return;
+    }
+    // The decision only depends on the graph, so it is made once here and logged with every query
+    const auto target = stats_.features();
+    const CalibrationPoint* nearest = nullptr;
+    double nearest_d = std::numeric_limits<double>::infinity();
+    for (const auto& p : table_.points) {
+        const auto f = p.stats.features();
+        double d = 0;
+        for (size_t i = 0; i < f.size(); ++i) {
+            d += (f[i] - target[i]) * (f[i] - target[i]);
+        }
+        if (d < nearest_d) {
+            nearest_d = d;
+            nearest = &p;
+        }
+    }
+    engine_ = nearest->fastest();
+
+    std::ostringstream reason;
+    reason << "nearest calibration point n=" << nearest->stats.n << " arcs=" << nearest->stats.arcs
+           << " distance=" << std::sqrt(nearest_d) << " ms:";
+    for (size_t e = 0; e < ENGINES.size(); ++e) {
+        reason << ' ' << engine_name(ENGINES[e]) << '=' << nearest->ms[e];
+    }
+    reason_ = reason.str();
+}
+
+std::vector<double> SSSPDispatcher::run(const Vertex* src) {
+    decisions_.push_back(DispatchDecision{src->id_, engine_, reason_});
+    if (log_ != nullptr) {
+        *log_ << "[dispatch] source=" << src->id_ << " n=" << stats_.n << " arcs=" << stats_.arcs
+              << " engine=" << engine_name(engine_) << " (" << reason_ << ")\n";
+    }
+    return run_engine(graph_, src, engine_, threads_);
+}
+
+std::vector<double> SSSPDispatcher::run_engine(Graph& graph, const Vertex* src, const Engine engine,
+                                               const size_t threads) {
+    switch (engine) {
+        case Engine::HeapDijkstra: {
+            Dijkstra dijkstra(graph, src);
+            dijkstra.set_record_frames(false);
+            return dijkstra.std_heap_run();
+        }
+        case Engine::FibDijkstra:
+            return Dijkstra(graph, src).fib_heap_run();
+        case Engine::BMSSP: {
+            BMSSP bmssp(graph, src);
+            bmssp.set_record_frames(false);
+            bmssp.set_threads(threads);
+            return bmssp.run();
+        }
+    }
+    return {};
+}
+
+}
@@ -0,0 +1,113 @@
+#ifndef ALGO_SEMINAR_SSSP_DISPATCHER_H
+#define ALGO_SEMINAR_SSSP_DISPATCHER_H
+
+#include <array>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Graph.h"
+
+namespace dispatch {
+
+enum class Engine {HeapDijkstra, FibDijkstra, BMSSP};
+
+inline constexpr std::array ENGINES = {Engine::HeapDijkstra, Engine::FibDijkstra, Engine::BMSSP};
+
+const char* engine_name(Engine engine);
+
+// Graph statistics the dispatcher decides on, one O(n + m) pass
+struct GraphStats {
+    size_t n = 0;
+    size_t arcs = 0;
+    double mean_degree = 0;
+    double degree_cv = 0;  // coefficient of variation of the out-degree, the degree skew
+    double weight_cv = 0;  // coefficient of variation of the edge weights
+    double weight_ratio = 1;  // max weight / min weight
+
+    // Position in the space calibration points are compared in
+    [[nodiscard]] std::array<double, 5> features() const;
+};
+
+GraphStats graph_stats(const Graph& graph);
+
+// Mean wall clock per query of every engine on one calibration graph
+struct CalibrationPoint {
+    GraphStats stats;
+    std::array<double, ENGINES.size()> ms{};
+
+    [[nodiscard]] Engine fastest() const;
+};
+
+/*
+Calibration table built by a local run (sssp_calibrate), one point per line:
+"<n> <arcs> <mean_degree> <degree_cv> <weight_cv> <weight_ratio> <heap ms> <fib ms> <bmssp ms>".
+Its path is $SSSP_CALIBRATION_FILE or sssp_calibration.txt in the working directory.
+*/
+struct CalibrationTable {
+    std::vector<CalibrationPoint> points;
+
+    static std::string path();
+    static CalibrationTable load();
+    void save() const;
+
+    // Time every engine on `sources` sampled sources of graph
+    static CalibrationPoint measure(Graph& graph, size_t sources, size_t threads = 1);
+};
+
+struct DispatchDecision {
+    uint64_t source;
+    Engine engine;
+    std::string reason;
+};
+
+/*
+Front-end that routes each query to the engine that was fastest on the nearest calibration point, nearest in
+(log n, log mean degree, degree skew, weight spread). Without a calibration table every query goes to the binary heap
+Dijkstra. Every decision is kept in decisions() and, if a log stream is set, written to it as one line.
+*/
+class SSSPDispatcher {
+    Graph& graph_;
+    GraphStats stats_;
+    CalibrationTable table_;
+    Engine engine_;
+    std::string reason_;
+    size_t threads_ = 1;
+    std::ostream* log_ = nullptr;
+    std::vector<DispatchDecision> decisions_;
+
+public:
+    explicit SSSPDispatcher(Graph& graph);
+
+    SSSPDispatcher(Graph& graph, CalibrationTable table);
+
+    std::vector<double> run(const Vertex* src);
+
+    void set_log(std::ostream* log) {
+        log_ = log;
+    }
+
+    // Threads handed to BMSSP when it is chosen
+    void set_threads(const size_t threads) {
+        threads_ = threads;
+    }
+
+    [[nodiscard]] Engine engine() const {
+        return engine_;
+    }
+
+    [[nodiscard]] const GraphStats& stats() const {
+        return stats_;
+    }
+
+    [[nodiscard]] const std::vector<DispatchDecision>& decisions() const {
+        return decisions_;
+    }
+
+    static std::vector<double> run_engine(Graph& graph, const Vertex* src, Engine engine, size_t threads = 1);
+};
+
+}
+
+
+#endif //ALGO_SEMINAR_SSSP_DISPATCHER_H
@@ -0,0 +1,24 @@
+#ifndef ALGO_SEMINAR_SSSP_GRAPH_H
+#define ALGO_SEMINAR_SSSP_GRAPH_H
+
+#include <concepts>
+#include <cstdint>
+#include <ranges>
+
+#include "Graph.h"
+
+/*
+Read access the SSSP engines are written against: the number of vertices, ids being 0 .. size() - 1, and the out-arcs
+of a vertex as a range of Edge. The range may be a reference to stored arcs (Graph, CSRGraph, GraphSnapshot) or a
+small value computed on the fly (GridGraph). The engines are instantiated per backend, so traversal is resolved and
+inlined at compile time.
+*/
+template <typename G>
+concept SSSPGraph = requires(const G& graph, const uint64_t v) {
+    { graph.size() } -> std::convertible_to<size_t>;
+    { graph.neighbors(v) } -> std::ranges::forward_range;
+    requires std::same_as<std::ranges::range_value_t<decltype(graph.neighbors(v))>, Edge>;
+};
+
+
+#endif //ALGO_SEMINAR_SSSP_GRAPH_H
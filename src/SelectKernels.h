@@ -0,0 +1,216 @@
+#ifndef ALGO_SEMINAR_SELECT_KERNELS_H
+#define ALGO_SEMINAR_SELECT_KERNELS_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/*
+Selection kernels over key/value pairs stored as two parallel arrays (values and key ids).
+Pairs are ordered by value first and key id second, the same order as Pair::operator<, so no
+comparison ever has to look at a Vertex. The AVX-512 and AVX2 paths are chosen at compile time
+(-march=native), the scalar path is always available.
+*/
+namespace select_kernels {
+
+inline bool less(const double va, const uint64_t ia, const double vb, const uint64_t ib) {
+    return va < vb || (va == vb && ia < ib);
+}
+
+// Partition src[0, n) around the pivot (pv, pid) into dst: pairs smaller than the pivot are written to the front of
+// dst, all others to the back. Returns the number of smaller pairs. src and dst must not overlap.
+inline size_t partition_scalar(const double* src_v, const uint64_t* src_i, const size_t n,
+                               const double pv, const uint64_t pid, double* dst_v, uint64_t* dst_i) {
+    size_t lo = 0, hi = n;
+    for (size_t j = 0; j < n; ++j) {
+        const double v = src_v[j];
+        const uint64_t id = src_i[j];
+        const bool lt = less(v, id, pv, pid);
+        // Branchless: write both candidate slots, advance only one of the cursors.
+        // The slot that is not advanced lies in the unfilled middle [lo, hi) and is overwritten later.
+        dst_v[lo] = v;
+        dst_i[lo] = id;
+        dst_v[hi - 1] = v;
+        dst_i[hi - 1] = id;
+        lo += lt;
+        hi -= !lt;
+    }
+    return lo;
+}
+
+#if defined(__AVX2__)
+namespace detail {
+// For every 4-bit mask, a permutation of 64-bit lanes (as pairs of 32-bit indices) moving the set lanes to the front
+// and the unset lanes to the back, both in their original order.
+inline const std::array<std::array<int32_t, 8>, 16>& compress_lut() {
+    static const auto lut = [] {
+        std::array<std::array<int32_t, 8>, 16> t{};
+        for (int m = 0; m < 16; ++m) {
+            int pos = 0;
+            for (int pass = 0; pass < 2; ++pass) {
+                for (int lane = 0; lane < 4; ++lane) {
+                    if (((m >> lane) & 1) != (pass == 0 ? 1 : 0)) continue;
+                    t[m][2 * pos] = 2 * lane;
+                    t[m][2 * pos + 1] = 2 * lane + 1;
+                    ++pos;
+                }
+            }
+        }
+        return t;
+    }();
+    return lut;
+}
+}
+
+inline size_t partition_avx2(const double* src_v, const uint64_t* src_i, const size_t n,
+                             const double pv, const uint64_t pid, double* dst_v, uint64_t* dst_i) {
+    const auto& lut = detail::compress_lut();
+    const __m256d pivot_v = _mm256_set1_pd(pv);
+    const __m256i pivot_i = _mm256_set1_epi64x(static_cast<long long>(pid));
+    size_t lo = 0, hi = n, j = 0;
+    // Each step stores 4 lanes at lo and 4 lanes ending at hi. With at least 8 unfilled slots the stray lanes of both
+    // stores land in the unfilled middle, everything smaller is finished by the scalar tail.
+    for (; n - j >= 8; j += 4) {
+        const __m256d v = _mm256_loadu_pd(src_v + j);
+        const __m256i id = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src_i + j));
+        const __m256d lt_v = _mm256_cmp_pd(v, pivot_v, _CMP_LT_OQ);
+        const __m256d eq_v = _mm256_cmp_pd(v, pivot_v, _CMP_EQ_OQ);
+        // ids are vertex indices < 2^63, so the signed 64-bit compare is exact
+        const __m256d lt_i = _mm256_castsi256_pd(_mm256_cmpgt_epi64(pivot_i, id));
+        const int mask = _mm256_movemask_pd(_mm256_or_pd(lt_v, _mm256_and_pd(eq_v, lt_i)));
+        const int cnt = __builtin_popcount(mask);
+
+        const __m256i perm = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lut[mask].data()));
+        const __m256d pv_out = _mm256_castsi256_pd(_mm256_permutevar8x32_epi32(_mm256_castpd_si256(v), perm));
+        const __m256i pi_out = _mm256_permutevar8x32_epi32(id, perm);
+
+        _mm256_storeu_pd(dst_v + lo, pv_out);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst_i + lo), pi_out);
+        _mm256_storeu_pd(dst_v + hi - 4, pv_out);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst_i + hi - 4), pi_out);
+        lo += cnt;
+        hi -= 4 - cnt;
+    }
+    return lo + partition_scalar(src_v + j, src_i + j, n - j, pv, pid, dst_v + lo, dst_i + lo);
+}
+#endif
+
+#if defined(__AVX512F__)
+inline size_t partition_avx512(const double* src_v, const uint64_t* src_i, const size_t n,
+                               const double pv, const uint64_t pid, double* dst_v, uint64_t* dst_i) {
+    const __m512d pivot_v = _mm512_set1_pd(pv);
+    const __m512i pivot_i = _mm512_set1_epi64(static_cast<long long>(pid));
+    size_t lo = 0, hi = n, j = 0;
+    for (; j + 8 <= n; j += 8) {
+        const __m512d v = _mm512_loadu_pd(src_v + j);
+        const __m512i id = _mm512_loadu_si512(src_i + j);
+        const __mmask8 lt = _mm512_cmp_pd_mask(v, pivot_v, _CMP_LT_OQ)
+                          | (_mm512_cmp_pd_mask(v, pivot_v, _CMP_EQ_OQ) & _mm512_cmplt_epu64_mask(id, pivot_i));
+        const __mmask8 ge = static_cast<__mmask8>(~lt);
+        const int cnt = __builtin_popcount(lt);
+        _mm512_mask_compressstoreu_pd(dst_v + lo, lt, v);
+        _mm512_mask_compressstoreu_epi64(dst_i + lo, lt, id);
+        _mm512_mask_compressstoreu_pd(dst_v + hi - (8 - cnt), ge, v);
+        _mm512_mask_compressstoreu_epi64(dst_i + hi - (8 - cnt), ge, id);
+        lo += cnt;
+        hi -= 8 - cnt;
+    }
+    return lo + partition_scalar(src_v + j, src_i + j, n - j, pv, pid, dst_v + lo, dst_i + lo);
+}
+#endif
+
+inline size_t partition(const double* src_v, const uint64_t* src_i, const size_t n,
+                        const double pv, const uint64_t pid, double* dst_v, uint64_t* dst_i) {
+#if defined(__AVX512F__)
+    return partition_avx512(src_v, src_i, n, pv, pid, dst_v, dst_i);
+#elif defined(__AVX2__)
+    return partition_avx2(src_v, src_i, n, pv, pid, dst_v, dst_i);
+#else
+    return partition_scalar(src_v, src_i, n, pv, pid, dst_v, dst_i);
+#endif
+}
+
+inline const char* isa_name() {
+#if defined(__AVX512F__)
+    return "avx512";
+#elif defined(__AVX2__)
+    return "avx2";
+#else
+    return "scalar";
+#endif
+}
+
+using PartitionFn = size_t (*)(const double*, const uint64_t*, size_t, double, uint64_t, double*, uint64_t*);
+
+/*
+Rearrange vals/ids[0, n) so that position k holds the (k+1)-th smallest pair, everything before it is smaller and
+everything after it is larger (like std::nth_element). Keys must be unique. scratch_v/scratch_i need room for n
+elements. Quickselect with median-of-three pivots; each round partitions into the scratch arrays and copies back.
+*/
+inline void select_kth(double* vals, uint64_t* ids, const size_t n, const size_t k,
+                       double* scratch_v, uint64_t* scratch_i, const PartitionFn part = partition) {
+    constexpr size_t SMALL = 16;
+    size_t lo = 0, hi = n;
+    auto swap_at = [&](const size_t a, const size_t b) {
+        std::swap(vals[a], vals[b]);
+        std::swap(ids[a], ids[b]);
+    };
+
+    while (hi - lo > SMALL) {
+        // Median of three, moved to hi - 1
+        const size_t a = lo, b = lo + (hi - lo) / 2, c = hi - 1;
+        size_t m;
+        if (less(vals[a], ids[a], vals[b], ids[b])) {
+            m = less(vals[b], ids[b], vals[c], ids[c]) ? b : (less(vals[a], ids[a], vals[c], ids[c]) ? c : a);
+        } else {
+            m = less(vals[a], ids[a], vals[c], ids[c]) ? a : (less(vals[b], ids[b], vals[c], ids[c]) ? c : b);
+        }
+        swap_at(m, hi - 1);
+        const double pv = vals[hi - 1];
+        const uint64_t pid = ids[hi - 1];
+
+        const size_t len = hi - 1 - lo;
+        const size_t cnt = part(vals + lo, ids + lo, len, pv, pid, scratch_v + lo, scratch_i + lo);
+        std::memcpy(vals + lo, scratch_v + lo, len * sizeof(double));
+        std::memcpy(ids + lo, scratch_i + lo, len * sizeof(uint64_t));
+
+        const size_t pos = lo + cnt;
+        swap_at(pos, hi - 1);
+        if (k == pos) return;
+        if (k < pos) hi = pos;
+        else lo = pos + 1;
+    }
+
+    // Insertion sort of the small remainder
+    for (size_t i = lo + 1; i < hi; ++i) {
+        const double v = vals[i];
+        const uint64_t id = ids[i];
+        size_t j = i;
+        while (j > lo && less(v, id, vals[j - 1], ids[j - 1])) {
+            vals[j] = vals[j - 1];
+            ids[j] = ids[j - 1];
+            --j;
+        }
+        vals[j] = v;
+        ids[j] = id;
+    }
+}
+
+inline double max_value(const double* vals, const size_t n) {
+    double m = -std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < n; ++i) m = std::max(m, vals[i]);
+    return m;
+}
+
+}
+
+
+#endif //ALGO_SEMINAR_SELECT_KERNELS_H
@@ -0,0 +1,53 @@
+#ifndef ALGO_SEMINAR_SPARSE_DISTANCES_H
+#define ALGO_SEMINAR_SPARSE_DISTANCES_H
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "PageAllocator.h"
+
+/*
+Distance array that is reset in O(1): an entry counts only if its stamp matches the current epoch. Allocated once per
+graph and reused across queries, so a query initialises just the vertices it reaches.
+*/
+class SparseDistances {
+    PageVector<double> dist_;
+    PageVector<uint32_t> stamp_;
+    uint32_t epoch_ = 1;
+
+public:
+    explicit SparseDistances(const size_t n) : dist_(n), stamp_(n, 0) {}
+
+    // Every entry back to infinity
+    void clear() {
+        if (++epoch_ == 0) {
+            // Wrapped around after 2^32 queries, stamps of the first epochs would count again
+            std::ranges::fill(stamp_, 0);
+            epoch_ = 1;
+        }
+    }
+
+    [[nodiscard]] double get(const uint64_t v) const {
+        return stamp_[v] == epoch_ ? dist_[v] : std::numeric_limits<double>::infinity();
+    }
+
+    void set(const uint64_t v, const double d) {
+        stamp_[v] = epoch_;
+        dist_[v] = d;
+    }
+
+    // Both entries of v, ahead of a get or set
+    void prefetch(const uint64_t v) const {
+        __builtin_prefetch(stamp_.data() + v, 1, 3);
+        __builtin_prefetch(dist_.data() + v, 1, 3);
+    }
+
+    [[nodiscard]] size_t size() const {
+        return dist_.size();
+    }
+};
+
+
+#endif //ALGO_SEMINAR_SPARSE_DISTANCES_H
@@ -0,0 +1,65 @@
+#include "TraceSink.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+void TraceSink::add(std::string name, const char phase, const std::initializer_list<Arg> args) {
+    Event e{std::move(name), phase, 0.0, {}, 0};
+    for (const Arg& arg : args) {
+        if (e.arg_count == std::size(e.args)) break;
+        e.args[e.arg_count++] = arg;
+    }
+    e.ts_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start_).count();
+    events_.push_back(std::move(e));
+}
+
+void TraceSink::clear() {
+    events_.clear();
+    start_ = std::chrono::steady_clock::now();
+}
+
+static void write_number(std::ostream& out, const double v) {
+    if (std::isfinite(v)) {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.17g", v);
+        out << buf;
+    } else {
+        out << (v > 0 ? "\"inf\"" : v < 0 ? "\"-inf\"" : "\"nan\"");
+    }
+}
+
+void TraceSink::write(std::ostream& out) const {
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    for (size_t i = 0; i < events_.size(); ++i) {
+        const Event& e = events_[i];
+        char ts[32];
+        std::snprintf(ts, sizeof(ts), "%.3f", e.ts_us);
+        out << "{\"ph\": \"" << e.phase << "\", \"pid\": 1, \"tid\": 1, \"ts\": " << ts;
+        if (e.phase != 'E') {
+            // Names are generated by the engines, never user input, so they need no escaping
+            out << ", \"name\": \"" << e.name << "\"";
+        }
+        if (e.phase == 'i') {
+            out << ", \"s\": \"t\"";
+        }
+        if (e.arg_count > 0) {
+            out << ", \"args\": {";
+            for (size_t a = 0; a < e.arg_count; ++a) {
+                out << (a == 0 ? "\"" : ", \"") << e.args[a].name << "\": ";
+                write_number(out, e.args[a].value);
+            }
+            out << "}";
+        }
+        out << (i + 1 == events_.size() ? "}\n" : "},\n");
+    }
+    out << "]}\n";
+}
+
+bool TraceSink::write(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) return false;
+    write(out);
+    return static_cast<bool>(out);
+}
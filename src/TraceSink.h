@@ -0,0 +1,66 @@
+#ifndef ALGO_SEMINAR_TRACE_SINK_H
+#define ALGO_SEMINAR_TRACE_SINK_H
+
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*
+Timestamped events in memory, written out as Chrome Trace Event JSON (chrome://tracing, ui.perfetto.dev). begin/end
+pairs nest into spans on one track, instant events mark points in time. Every event carries up to three numeric
+arguments; infinite values are written as the string "inf". Recording an event is a clock read and a push_back, the
+JSON is only built by write. Not thread-safe, one sink per engine run.
+*/
+class TraceSink {
+public:
+    struct Arg {
+        const char* name;
+        double value;
+    };
+
+private:
+    struct Event {
+        std::string name;
+        char phase;  // 'B', 'E' or 'i'
+        double ts_us;
+        Arg args[3];
+        uint8_t arg_count;
+    };
+
+    std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+    std::vector<Event> events_;
+
+    void add(std::string name, char phase, std::initializer_list<Arg> args);
+
+public:
+    void begin(std::string name, const std::initializer_list<Arg> args = {}) {
+        add(std::move(name), 'B', args);
+    }
+
+    // Closes the innermost open span, its arguments are merged into the span by the viewer
+    void end(const std::initializer_list<Arg> args = {}) {
+        add({}, 'E', args);
+    }
+
+    void instant(std::string name, const std::initializer_list<Arg> args = {}) {
+        add(std::move(name), 'i', args);
+    }
+
+    [[nodiscard]] size_t size() const {
+        return events_.size();
+    }
+
+    // Drops every event and restarts the clock
+    void clear();
+
+    void write(std::ostream& out) const;
+
+    // False if the file could not be written
+    bool write(const std::string& path) const;
+};
+
+
+#endif //ALGO_SEMINAR_TRACE_SINK_H